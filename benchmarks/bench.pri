@@ -0,0 +1,17 @@
+# 各基准共用的设置，源码直接引用 src 下的文件
+
+QT -= gui
+
+CONFIG += c++17 console
+CONFIG -= app_bundle
+
+SRC_DIR = $$PWD/../src
+
+INCLUDEPATH += $$SRC_DIR $$PWD/common
+DEPENDPATH += $$SRC_DIR $$PWD/common
+
+HEADERS += \
+    $$PWD/common/RecordedStream.h \
+    $$PWD/common/SyntheticFrame.h
+
+include($$PWD/../3rdpart/ffmpeg/ffmpeg.pri)
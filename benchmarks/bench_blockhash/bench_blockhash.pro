@@ -0,0 +1,12 @@
+TARGET = bench_blockhash
+
+include(../bench.pri)
+
+HEADERS += \
+    $$SRC_DIR/BlockHasher.h \
+    $$SRC_DIR/YuvConverter.h
+
+SOURCES += \
+    main.cpp \
+    $$SRC_DIR/BlockHasher.cpp \
+    $$SRC_DIR/YuvConverter.cpp
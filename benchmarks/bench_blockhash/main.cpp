@@ -0,0 +1,219 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include "BlockHasher.h"
+#include "YuvConverter.h"
+#include "SyntheticFrame.h"
+
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// 每帧模拟的局部更新: 一行输入的文字，宽 x 高
+#define TOUCH_WIDTH 48
+#define TOUCH_HEIGHT 16
+
+// 阈值扫描时变化块占全部块的比例（千分比）
+static const int SWEEP_PERMILLE[] = { 1, 10, 50, 100, 200, 300, 500 };
+
+// 与 VideoDecoderWorker::convertChangedBlocks 相同: 变化块的连续段交给 YUV 内核，未变化段从上一帧拷贝
+static void convertChangedBlocks(const BlockHasher& hasher, const YuvConverter& converter, const AVFrame* frame,
+                                 const uint8_t* previous, uint8_t* dst, int dstStride)
+{
+    const int block = BlockHasher::BLOCK_SIZE;
+    bool nv12 = frame->format == AV_PIX_FMT_NV12;
+    for (int by = 0; by < hasher.rows(); ++by)
+    {
+        int rowBegin = by * block;
+        int rowEnd = qMin(rowBegin + block, frame->height);
+        int bx = 0;
+        while (bx < hasher.columns())
+        {
+            bool changed = hasher.isChanged(bx, by);
+            int end = bx + 1;
+            while (end < hasher.columns() && hasher.isChanged(end, by) == changed)
+            {
+                ++end;
+            }
+            int x = bx * block;
+            int width = qMin(end * block, frame->width) - x;
+            if (changed)
+            {
+                converter.convertRows(frame->data[0] + x, frame->linesize[0],
+                                      frame->data[1] + (nv12 ? x : x / 2), frame->linesize[1],
+                                      nv12 ? nullptr : frame->data[2] + x / 2, nv12 ? 0 : frame->linesize[2], nv12,
+                                      dst + x * 4, dstStride, false, width, rowBegin, rowEnd);
+            }
+            else
+            {
+                for (int row = rowBegin; row < rowEnd; ++row)
+                {
+                    memcpy(dst + static_cast<ptrdiff_t>(row) * dstStride + x * 4,
+                           previous + static_cast<ptrdiff_t>(row) * dstStride + x * 4, width * 4);
+                }
+            }
+            bx = end;
+        }
+    }
+}
+
+// 让 count 个块发生变化: clustered 为从左上角起连续的块（窗口内容更新），否则为分散的随机块
+static void touchBlocks(AVFrame* frame, const BlockHasher& hasher, int count, bool clustered)
+{
+    const int block = BlockHasher::BLOCK_SIZE;
+    uint32_t state = 7;
+    for (int i = 0; i < count; ++i)
+    {
+        int column = clustered ? i % hasher.columns() : static_cast<int>(syntheticRandom(state) % hasher.columns());
+        int row = clustered ? i / hasher.columns() : static_cast<int>(syntheticRandom(state) % hasher.rows());
+        touchSyntheticRegion(frame, column * block, row * block, block, block, i + 1);
+    }
+}
+
+// 逐块变化检测的开销和收益，合成的桌面画面每帧只改动一小块（输入文字）
+//   hash:   各哈希内核每帧耗时与吞吐，变化块数与标量实现不一致时报错
+//   before: 每帧整帧转换（关闭 changeDetection）
+//   after:  每帧先哈希，再只转换变化块、其余从上一帧拷贝
+//   sweep:  哈希已算好时，按块转换与整帧转换在不同变化比例下的耗时，
+//           对应 VideoDecoderWorker 的 PARTIAL_CONVERT_MAX_PERCENT
+// 录制码流上的跳过比例见 bench_decode
+// 用法: bench_blockhash [WxH] [轮数]
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QStringList args = app.arguments();
+
+    int width = 1920;
+    int height = 1080;
+    if (args.size() > 1)
+    {
+        parseSyntheticSize(args[1].toLatin1().constData(), width, height);
+    }
+    int rounds = qMax(1, args.size() > 2 ? args[2].toInt() : 200);
+
+    int dstStride = (width * 4 + 31) & ~31;
+    std::vector<uint8_t> previous(static_cast<size_t>(dstStride) * height);
+    std::vector<uint8_t> dst(previous.size());
+    YuvConverter converter;
+    bool ok = true;
+
+    out << QString("%1x%2, %3 rounds, %4x%5 touched per frame, convert kernel %6")
+               .arg(width).arg(height).arg(rounds).arg(TOUCH_WIDTH).arg(TOUCH_HEIGHT)
+               .arg(YuvConverter::kernelName(converter.kernel())) << "\n";
+
+    for (AVPixelFormat format : { AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12 })
+    {
+        AVFrame* frame = allocSyntheticFrame(width, height, format);
+        if (!frame)
+        {
+            out << "Could not allocate frame\n";
+            return 1;
+        }
+        const char* formatName = format == AV_PIX_FMT_NV12 ? "nv12" : "yuv420p";
+        double frameBytes = width * static_cast<double>(height) * 1.5;
+
+        // 每种内核从同一初始画面开始，按同样的顺序改动，变化块数应完全相同
+        std::vector<int> scalarChanges;
+        const BlockHasher::Kernel kernels[] = { BlockHasher::KernelScalar, BlockHasher::KernelSSE2,
+                                                BlockHasher::KernelNEON };
+        for (BlockHasher::Kernel kernel : kernels)
+        {
+            if (!BlockHasher::isKernelSupported(kernel))
+            {
+                continue;
+            }
+            fillDesktopFrame(frame, 1);
+            BlockHasher hasher(kernel);
+            hasher.update(frame);
+            std::vector<int> changes;
+            qint64 ns = 0;
+            for (int i = 0; i < rounds; ++i)
+            {
+                touchSyntheticRegion(frame, (i * 37) % width, (i * 53) % height, TOUCH_WIDTH, TOUCH_HEIGHT, i + 1);
+                QElapsedTimer timer;
+                timer.start();
+                changes.push_back(hasher.update(frame));
+                ns += timer.nsecsElapsed();
+            }
+            if (kernel == BlockHasher::KernelScalar)
+            {
+                scalarChanges = changes;
+            }
+            else if (changes != scalarChanges)
+            {
+                out << BlockHasher::kernelName(kernel) << ": changed blocks differ from scalar\n";
+                ok = false;
+            }
+            ns = qMax<qint64>(1, ns);
+            out << QString("%1 hash %2: %3 us/frame, %4 GB/s")
+                       .arg(formatName).arg(BlockHasher::kernelName(kernel))
+                       .arg(ns / 1000.0 / rounds, 0, 'f', 1)
+                       .arg(frameBytes * rounds / ns, 0, 'f', 2) << "\n";
+        }
+
+        // before / after，使用最快的哈希内核
+        fillDesktopFrame(frame, 1);
+        converter.convert(frame, AV_PIX_FMT_BGRA, previous.data(), dstStride, 0, height);
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < rounds; ++i)
+        {
+            touchSyntheticRegion(frame, (i * 37) % width, (i * 53) % height, TOUCH_WIDTH, TOUCH_HEIGHT, i + 1);
+            converter.convert(frame, AV_PIX_FMT_BGRA, dst.data(), dstStride, 0, height);
+        }
+        qint64 beforeNs = timer.nsecsElapsed();
+
+        fillDesktopFrame(frame, 1);
+        BlockHasher hasher;
+        hasher.update(frame);
+        converter.convert(frame, AV_PIX_FMT_BGRA, previous.data(), dstStride, 0, height);
+        qint64 changedPixels = 0;
+        timer.restart();
+        for (int i = 0; i < rounds; ++i)
+        {
+            touchSyntheticRegion(frame, (i * 37) % width, (i * 53) % height, TOUCH_WIDTH, TOUCH_HEIGHT, i + 1);
+            hasher.update(frame);
+            changedPixels += hasher.changedPixels();
+            convertChangedBlocks(hasher, converter, frame, previous.data(), dst.data(), dstStride);
+            previous.swap(dst);
+        }
+        qint64 afterNs = timer.nsecsElapsed();
+
+        out << QString("%1 before (full convert): %2 us/frame").arg(formatName).arg(beforeNs / 1000.0 / rounds, 0, 'f', 1)
+            << "\n";
+        out << QString("%1 after (%2 hash + changed blocks): %3 us/frame, %4% pixels converted")
+                   .arg(formatName).arg(BlockHasher::kernelName(hasher.kernel()))
+                   .arg(afterNs / 1000.0 / rounds, 0, 'f', 1)
+                   .arg(changedPixels * 100.0 / (static_cast<double>(width) * height * rounds), 0, 'f', 2) << "\n";
+
+        // 阈值扫描: 变化检测开启时哈希总要算，这里只比较其后的转换
+        for (int permille : SWEEP_PERMILLE)
+        {
+            for (bool clustered : { true, false })
+            {
+                fillDesktopFrame(frame, 1);
+                hasher.reset();
+                hasher.update(frame);
+                touchBlocks(frame, hasher, qMax(1, hasher.blockCount() * permille / 1000), clustered);
+                hasher.update(frame);
+                timer.restart();
+                for (int i = 0; i < rounds; ++i)
+                {
+                    convertChangedBlocks(hasher, converter, frame, previous.data(), dst.data(), dstStride);
+                }
+                qint64 partialNs = timer.nsecsElapsed();
+                out << QString("%1 sweep %2% changed (%3): changed blocks %4 us/frame, full %5 us/frame")
+                           .arg(formatName)
+                           .arg(hasher.changedPixels() * 100.0 / (static_cast<double>(width) * height), 0, 'f', 1)
+                           .arg(clustered ? "clustered" : "scattered")
+                           .arg(partialNs / 1000.0 / rounds, 0, 'f', 1)
+                           .arg(beforeNs / 1000.0 / rounds, 0, 'f', 1) << "\n";
+            }
+        }
+        av_frame_free(&frame);
+    }
+    return ok ? 0 : 1;
+}
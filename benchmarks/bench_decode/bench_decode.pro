@@ -0,0 +1,17 @@
+TARGET = bench_decode
+
+include(../bench.pri)
+
+HEADERS += \
+    $$SRC_DIR/BlockHasher.h \
+    $$SRC_DIR/H264Nal.h \
+    $$SRC_DIR/NalIndex.h \
+    $$SRC_DIR/PacketPool.h \
+    $$SRC_DIR/StreamParser.h
+
+SOURCES += \
+    main.cpp \
+    $$SRC_DIR/BlockHasher.cpp \
+    $$SRC_DIR/H264Nal.cpp \
+    $$SRC_DIR/PacketPool.cpp \
+    $$SRC_DIR/StreamParser.cpp
@@ -0,0 +1,253 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QSize>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+
+#include "BlockHasher.h"
+#include "PacketPool.h"
+#include "StreamParser.h"
+#include "RecordedStream.h"
+
+#include <cstring>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+// 与 VideoDecoderWorker 相同: 自动选择时的切片线程数上限
+#define MAX_DECODE_THREADS 4
+
+// 与 VideoDecoderWorker 相同的编码格式到 FFmpeg 解码器的对应
+static AVCodecID avCodecIdFor(DeskVideoCodec videoCodec)
+{
+    switch (videoCodec)
+    {
+    case VIDEO_CODEC_HEVC:
+        return AV_CODEC_ID_HEVC;
+    case VIDEO_CODEC_MJPEG:
+        return AV_CODEC_ID_MJPEG;
+    default:
+        return AV_CODEC_ID_H264;
+    }
+}
+
+// 与 VideoDecoderWorker 相同的解码器设置，失败返回 nullptr
+static AVCodecContext* openDecoder(const AVCodec* codec, int decodeThreads)
+{
+    AVCodecContext* ctx = avcodec_alloc_context3(codec);
+    if (!ctx)
+    {
+        return nullptr;
+    }
+    ctx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    ctx->flags2 |= AV_CODEC_FLAG2_CHUNKS;
+    ctx->thread_type = FF_THREAD_SLICE;
+    ctx->thread_count = decodeThreads;
+    if (avcodec_open2(ctx, codec, nullptr) < 0)
+    {
+        avcodec_free_context(&ctx);
+    }
+    return ctx;
+}
+
+// 每包的开销，分开计时
+//   fillNs: 把消息放进 AVPacket 加上 av_packet_unref
+//   sendNs: avcodec_send_packet
+struct PacketTiming
+{
+    qint64 packets = 0;
+    qint64 fillNs = 0;
+    qint64 sendNs = 0;
+};
+
+// 基线: 每包 av_new_packet 新分配缓冲并 memcpy，不经过 PacketPool
+// 与 PacketPool 一样把整个码流解码一遍，解码器持有引用的时长相同，分配器的状态才可比
+static bool measureNewPacket(const AVCodec* codec, int decodeThreads, const QVector<QByteArray>& messages,
+                             PacketTiming& timing)
+{
+    AVCodecContext* ctx = openDecoder(codec, decodeThreads);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* pkt = av_packet_alloc();
+    bool ok = ctx && frame && pkt;
+    for (int i = 0; ok && i < messages.size(); ++i)
+    {
+        const QByteArray& message = messages[i];
+        QElapsedTimer timer;
+        timer.start();
+        if (av_new_packet(pkt, message.size()) < 0)
+        {
+            ok = false;
+            break;
+        }
+        memcpy(pkt->data, message.constData(), message.size());
+        timing.fillNs += timer.nsecsElapsed();
+        timer.restart();
+        avcodec_send_packet(ctx, pkt);
+        timing.sendNs += timer.nsecsElapsed();
+        timer.restart();
+        av_packet_unref(pkt);
+        timing.fillNs += timer.nsecsElapsed();
+        ++timing.packets;
+        while (avcodec_receive_frame(ctx, frame) >= 0)
+        {
+            av_frame_unref(frame);
+        }
+    }
+    avcodec_free_context(&ctx);
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    return ok;
+}
+
+// 解码一个录制文件，输出平均每帧耗时、每包的 PacketPool 开销（与每包 av_new_packet 的基线比较），
+// 以及逐块变化检测能跳过的比例（与 changeDetection 相同的比较）
+// 失败返回 false
+static bool benchmarkStream(const QString& path, int decodeThreads, QTextStream& out)
+{
+    QVector<QByteArray> messages;
+    if (!readRecordedStream(path, messages))
+    {
+        out << "Could not read " << path << "\n";
+        return false;
+    }
+
+    DeskVideoCodec videoCodec = VIDEO_CODEC_AUTO;
+    for (int i = 0; i < messages.size() && videoCodec == VIDEO_CODEC_AUTO; ++i)
+    {
+        videoCodec = sniffVideoCodec(reinterpret_cast<const uint8_t*>(messages[i].constData()), messages[i].size());
+    }
+    const AVCodec* codec = avcodec_find_decoder(avCodecIdFor(videoCodec));
+    if (videoCodec == VIDEO_CODEC_AUTO || !codec)
+    {
+        out << path << ": unknown or unsupported codec\n";
+        return false;
+    }
+
+    AVCodecContext* ctx = openDecoder(codec, decodeThreads);
+    AVFrame* frame = av_frame_alloc();
+    AVPacket* pkt = av_packet_alloc();
+    PacketPool pool;
+    bool ok = ctx && frame && pkt;
+
+    int frames = 0;
+    qint64 bytes = 0;
+    QSize size;
+    BlockHasher hasher;
+    int identicalFrames = 0;
+    qint64 hashedPixels = 0;
+    qint64 skippedPixels = 0;
+    qint64 hashNs = 0;
+    PacketTiming pooled;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; ok && i < messages.size(); ++i)
+    {
+        const QByteArray& message = messages[i];
+        QElapsedTimer packetTimer;
+        packetTimer.start();
+        if (!pool.fill(pkt, reinterpret_cast<const uint8_t*>(message.constData()), message.size()))
+        {
+            break;
+        }
+        pooled.fillNs += packetTimer.nsecsElapsed();
+        bytes += message.size();
+        packetTimer.restart();
+        avcodec_send_packet(ctx, pkt);
+        pooled.sendNs += packetTimer.nsecsElapsed();
+        packetTimer.restart();
+        av_packet_unref(pkt);
+        pooled.fillNs += packetTimer.nsecsElapsed();
+        ++pooled.packets;
+        while (avcodec_receive_frame(ctx, frame) >= 0)
+        {
+            size = QSize(frame->width, frame->height);
+            ++frames;
+            if (BlockHasher::supports(frame))
+            {
+                QElapsedTimer hashTimer;
+                hashTimer.start();
+                int changed = hasher.update(frame);
+                hashNs += hashTimer.nsecsElapsed();
+                qint64 pixels = static_cast<qint64>(frame->width) * frame->height;
+                hashedPixels += pixels;
+                skippedPixels += pixels - hasher.changedPixels();
+                if (changed == 0)
+                {
+                    ++identicalFrames;
+                }
+            }
+            av_frame_unref(frame);
+        }
+    }
+    // 解码耗时不含哈希
+    qint64 ns = qMax<qint64>(1, timer.nsecsElapsed() - hashNs);
+
+    if (ok)
+    {
+        out << QString("%1: %2 (%3) %4x%5, %6 frames, %7 KB/frame, %8 ms/frame (%9 fps)")
+                   .arg(path).arg(videoCodecName(videoCodec)).arg(codec->name)
+                   .arg(size.width()).arg(size.height()).arg(frames)
+                   .arg(frames > 0 ? bytes / 1024 / frames : 0)
+                   .arg(frames > 0 ? ns / 1e6 / frames : 0.0, 0, 'f', 2)
+                   .arg(frames * 1e9 / ns, 0, 'f', 1) << "\n";
+        if (hashedPixels > 0)
+        {
+            out << QString("  change detection (%1): %2 us/frame hash, %3% pixels unchanged, %4 identical frames")
+                       .arg(BlockHasher::kernelName(hasher.kernel()))
+                       .arg(hashNs / 1000 / frames)
+                       .arg(skippedPixels * 100.0 / hashedPixels, 0, 'f', 1)
+                       .arg(identicalFrames) << "\n";
+        }
+
+        PacketTiming baseline;
+        if (pooled.packets > 0 && measureNewPacket(codec, decodeThreads, messages, baseline) && baseline.packets > 0)
+        {
+            out << QString("  packet overhead: PacketPool %1 us/packet (%2 regrows), av_new_packet+memcpy %3 us/packet; "
+                           "avcodec_send_packet %4 us/packet")
+                       .arg(pooled.fillNs / 1000.0 / pooled.packets, 0, 'f', 2)
+                       .arg(pool.regrowCount())
+                       .arg(baseline.fillNs / 1000.0 / baseline.packets, 0, 'f', 2)
+                       .arg(pooled.sendNs / 1000.0 / pooled.packets, 0, 'f', 1) << "\n";
+        }
+    }
+    else
+    {
+        out << path << ": could not open " << codec->name << "\n";
+    }
+
+    avcodec_free_context(&ctx);
+    av_frame_free(&frame);
+    av_packet_free(&pkt);
+    return ok && frames > 0;
+}
+
+// 依次解码 StreamRecorder 录制的文件（配置项 recordStreamPath），比较各编码格式的解码耗时
+// 用法: bench_decode [-t 解码线程数] 录制文件...
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QStringList args = app.arguments().mid(1);
+
+    // 默认与 decodeThreads 为 0 时的自动选择相同
+    int decodeThreads = qBound(1, QThread::idealThreadCount(), MAX_DECODE_THREADS);
+    if (args.size() > 1 && args[0] == "-t")
+    {
+        decodeThreads = qMax(1, args[1].toInt());
+        args = args.mid(2);
+    }
+    if (args.isEmpty())
+    {
+        out << "Usage: bench_decode [-t threads] recording...\n";
+        return 1;
+    }
+
+    bool ok = true;
+    for (const QString& path : args)
+    {
+        ok = benchmarkStream(path, decodeThreads, out) && ok;
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,17 @@
+# ThreadTuning.cpp 同时包含写日志的 applyThreadPolicy，需要一起链接日志窗口
+TARGET = bench_jitter
+
+include(../bench.pri)
+
+QT += widgets
+
+HEADERS += \
+    $$SRC_DIR/LogWidget.h \
+    $$SRC_DIR/StreamStats.h \
+    $$SRC_DIR/ThreadTuning.h
+
+SOURCES += \
+    main.cpp \
+    $$SRC_DIR/LogWidget.cpp \
+    $$SRC_DIR/StreamStats.cpp \
+    $$SRC_DIR/ThreadTuning.cpp
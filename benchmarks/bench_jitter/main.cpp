@@ -0,0 +1,120 @@
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+#include "ThreadTuning.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// 唤醒周期和采样数（约 2 秒）
+#define JITTER_PERIOD_US 5000
+#define JITTER_SAMPLES 400
+
+// 在新线程上以 5ms 周期定时唤醒，返回各次唤醒相对预定时间的延迟（微秒，已排序）
+// policy 为空时使用默认调度
+static QVector<qint64> measureWakeupLatency(const DeskThreadPolicy* policy, QStringList& errors)
+{
+    QVector<qint64> latencies;
+    latencies.reserve(JITTER_SAMPLES);
+    QThread* thread = QThread::create([policy, &latencies, &errors]() {
+        if (policy)
+        {
+            setCurrentThreadPolicy(*policy, errors);
+        }
+        auto next = std::chrono::steady_clock::now();
+        for (int i = 0; i < JITTER_SAMPLES; ++i)
+        {
+            next += std::chrono::microseconds(JITTER_PERIOD_US);
+            std::this_thread::sleep_until(next);
+            latencies << std::chrono::duration_cast<std::chrono::microseconds>(
+                             std::chrono::steady_clock::now() - next).count();
+        }
+    });
+    thread->start();
+    thread->wait();
+    delete thread;
+
+    std::sort(latencies.begin(), latencies.end());
+    return latencies;
+}
+
+static QString latencySummary(const QVector<qint64>& latencies)
+{
+    if (latencies.isEmpty())
+    {
+        return "no samples";
+    }
+    return QString("p50 %1us p99 %2us max %3us")
+        .arg(latencies[latencies.size() / 2])
+        .arg(latencies[latencies.size() * 99 / 100])
+        .arg(latencies.last());
+}
+
+// 调度抖动: 每个核心上起一个忙循环线程作为背景负载（模拟 UI 和其它应用的后台工作），
+// 分别以默认调度和给定策略运行定时唤醒，比较唤醒延迟的 p50/p99/max
+// 用法: bench_jitter [nice] [any|big|little]，默认与解码线程的默认策略相同
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QStringList args = app.arguments();
+
+    DeskThreadPolicy policy = { -4, CORES_BIG };
+    if (args.size() > 1)
+    {
+        policy.nice = qBound(-20, args[1].toInt(), 19);
+    }
+    if (args.size() > 2)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            if (args[2].toLower() == coreSetName(static_cast<DeskCoreSet>(i)))
+            {
+                policy.cores = static_cast<DeskCoreSet>(i);
+            }
+        }
+    }
+
+    std::atomic<bool> stop{false};
+    QVector<QThread*> loadThreads;
+    for (int i = 0; i < QThread::idealThreadCount(); ++i)
+    {
+        QThread* thread = QThread::create([&stop]() {
+            volatile quint64 counter = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                ++counter;
+            }
+        });
+        thread->start();
+        loadThreads << thread;
+    }
+
+    QStringList errors;
+    QVector<qint64> defaults = measureWakeupLatency(nullptr, errors);
+    QVector<qint64> tuned = measureWakeupLatency(&policy, errors);
+
+    stop = true;
+    for (QThread* thread : loadThreads)
+    {
+        thread->wait();
+        delete thread;
+    }
+
+    out << QString("%1 load threads, %2us period").arg(loadThreads.size()).arg(JITTER_PERIOD_US) << "\n";
+    out << "default: " << latencySummary(defaults) << "\n";
+    out << QString("nice %1 %2 cores: ").arg(policy.nice).arg(coreSetName(policy.cores))
+        << latencySummary(tuned) << "\n";
+    if (!errors.isEmpty())
+    {
+        // 没有降低 nice 的权限时第二组结果等同于默认调度
+        out << "Policy not fully applied: " << errors.join("; ") << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,11 @@
+TARGET = bench_nalscan
+
+include(../bench.pri)
+
+HEADERS += \
+    $$SRC_DIR/H264Nal.h \
+    $$SRC_DIR/NalIndex.h
+
+SOURCES += \
+    main.cpp \
+    $$SRC_DIR/H264Nal.cpp
@@ -0,0 +1,153 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+
+#include "H264Nal.h"
+#include "RecordedStream.h"
+
+#include <cstring>
+
+// 拼接后的样本大小，模拟高码率下的多 MB 关键帧
+#define SAMPLE_BYTES (8 * 1024 * 1024)
+
+// 合成样本里每个片的大小（每片一个起始码）
+#define SYNTHETIC_SLICE_BYTES (128 * 1024)
+
+// 合成 IDR: 随机字节模拟熵编码数据，按 H.264 规则插入防竞争字节，不会出现伪起始码
+static QByteArray syntheticKeyFrame()
+{
+    QByteArray frame;
+    frame.reserve(SYNTHETIC_SLICE_BYTES * 4 + 64);
+    const char sps[] = { 0, 0, 0, 1, 0x67, 0x42, (char)0xC0, 0x28 };
+    const char pps[] = { 0, 0, 0, 1, 0x68, (char)0xCE, 0x3C, (char)0x80 };
+    frame.append(sps, sizeof(sps));
+    frame.append(pps, sizeof(pps));
+
+    quint32 state = 1;
+    for (int slice = 0; slice < 4; ++slice)
+    {
+        const char header[] = { 0, 0, 1, 0x65, (char)(slice == 0 ? 0x88 : 0x9A) };
+        frame.append(header, sizeof(header));
+        int zeros = 0;
+        for (int i = 0; i < SYNTHETIC_SLICE_BYTES; ++i)
+        {
+            state = state * 1664525u + 1013904223u;
+            char b = static_cast<char>(state >> 24);
+            if (zeros >= 2 && static_cast<uint8_t>(b) <= 3)
+            {
+                frame.append(char(3));
+                zeros = 0;
+            }
+            frame.append(b);
+            zeros = b == 0 ? zeros + 1 : 0;
+        }
+    }
+    return frame;
+}
+
+// 录制文件里第一个含 IDR 的 H.264 消息
+static QByteArray recordedKeyFrame(const QString& path)
+{
+    QVector<QByteArray> messages;
+    readRecordedStream(path, messages);
+    for (const QByteArray& message : messages)
+    {
+        if (parseH264Packet(reinterpret_cast<const uint8_t*>(message.constData()), message.size()).hasIdr)
+        {
+            return message;
+        }
+    }
+    return QByteArray();
+}
+
+// 比较各起始码扫描实现的吞吐量，以 memcpy 作为内存带宽参考
+// 用法: bench_nalscan [录制文件] [轮数]
+// 不给录制文件时使用合成的 IDR
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QStringList args = app.arguments();
+
+    QByteArray keyFrame;
+    QString source = "synthetic";
+    if (args.size() > 1)
+    {
+        keyFrame = recordedKeyFrame(args[1]);
+        source = args[1];
+        if (keyFrame.isEmpty())
+        {
+            out << "No H.264 IDR message in " << args[1] << "\n";
+            return 1;
+        }
+    }
+    else
+    {
+        keyFrame = syntheticKeyFrame();
+    }
+    int rounds = qMax(1, args.size() > 2 ? args[2].toInt() : 20);
+
+    // IDR 重复拼到 8MB 以上
+    QByteArray sample;
+    sample.reserve(SAMPLE_BYTES + keyFrame.size());
+    while (sample.size() < SAMPLE_BYTES)
+    {
+        sample.append(keyFrame);
+    }
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(sample.constData());
+    int size = sample.size();
+
+    out << QString("%1: IDR %2 bytes, sample %3 bytes, %4 rounds").arg(source).arg(keyFrame.size())
+               .arg(size).arg(rounds) << "\n";
+
+    typedef int (*ScanFunc)(const uint8_t*, int, int);
+    struct Scanner { const char* name; ScanFunc func; };
+    const Scanner scanners[] = {
+        { "bytewise", findH264StartCodeBytewise },
+        { "memchr", findH264StartCodeMemchr },
+        { h264StartCodeScannerName(), findH264StartCode }
+    };
+
+    int expected = -1;
+    bool consistent = true;
+    for (const Scanner& scanner : scanners)
+    {
+        int count = 0;
+        QElapsedTimer timer;
+        timer.start();
+        for (int i = 0; i < rounds; ++i)
+        {
+            for (int pos = scanner.func(data, size, 0); pos < size; pos = scanner.func(data, size, pos + 3))
+            {
+                ++count;
+            }
+        }
+        qint64 ns = qMax<qint64>(1, timer.nsecsElapsed() / rounds);
+        count /= rounds;
+        // 各实现找到的起始码数必须一致
+        if (expected < 0)
+        {
+            expected = count;
+        }
+        consistent = consistent && count == expected;
+        out << QString("%1: %2 MB/s (%3 nal)").arg(scanner.name).arg(size * 1000.0 / ns, 0, 'f', 0).arg(count) << "\n";
+    }
+
+    QByteArray copy(size, Qt::Uninitialized);
+    QElapsedTimer copyTimer;
+    copyTimer.start();
+    for (int i = 0; i < rounds; ++i)
+    {
+        memcpy(copy.data(), sample.constData(), size);
+    }
+    qint64 copyNs = qMax<qint64>(1, copyTimer.nsecsElapsed() / rounds);
+    out << QString("memcpy: %1 MB/s").arg(size * 1000.0 / copyNs, 0, 'f', 0) << "\n";
+
+    if (!consistent)
+    {
+        out << "Scanners disagree on the start code count\n";
+        return 1;
+    }
+    return 0;
+}
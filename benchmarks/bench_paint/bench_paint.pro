@@ -0,0 +1,9 @@
+TARGET = bench_paint
+
+include(../bench.pri)
+
+QT += gui
+
+HEADERS += $$SRC_DIR/DeskDefine.h
+
+SOURCES += main.cpp
@@ -0,0 +1,128 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QRegion>
+#include <QStringList>
+#include <QTextStream>
+
+#include "DeskDefine.h"
+#include "SyntheticFrame.h"
+
+#include <functional>
+
+// 解码线程可输出的帧格式: 改动前的 RGBA8888，以及 pixelFormat 可选的 rgb32 / rgb16
+struct SourceFormat { const char* name; QImage::Format format; };
+static const SourceFormat SOURCE_FORMATS[] = {
+    { "rgba8888", QImage::Format_RGBA8888 },
+    { "rgb32", QImage::Format_RGB32 },
+    { "rgb16", QImage::Format_RGB16 }
+};
+
+// VideoWidget 每帧绘制的开销，在与后备存储相同格式（RGB32）的 QImage 上模拟，每种帧格式各测一遍
+//   full:   改动前，每帧填满整个控件、重新计算黑边，再按显示区域 drawImage
+//   opaque: 现在，刷新区域只有显示区域，黑边不重画，尺寸一致时 1:1 贴图
+//   smooth/fast: 尺寸刚变化、解码线程尚未跟上时的临时缩放，平滑插值与最近邻
+// 帧格式与后备存储不同时 drawImage 每次都要转换，差值就是选错输出格式的代价
+// 用法: bench_paint [控件WxH] [远端WxH] [轮数]
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+    QStringList args = app.arguments();
+
+    int widgetW = 2400;
+    int widgetH = 1080;
+    int remoteW = 1920;
+    int remoteH = 1080;
+    if (args.size() > 1)
+    {
+        parseSyntheticSize(args[1].toLatin1().constData(), widgetW, widgetH);
+    }
+    if (args.size() > 2)
+    {
+        parseSyntheticSize(args[2].toLatin1().constData(), remoteW, remoteH);
+    }
+    int rounds = qMax(1, args.size() > 3 ? args[3].toInt() : 200);
+
+    QSize widgetSize(widgetW, widgetH);
+    QSize remoteSize(remoteW, remoteH);
+    QRect drawRect = deskLetterboxRect(widgetSize, remoteSize);
+    if (drawRect.isEmpty())
+    {
+        out << "Empty display rect\n";
+        return 1;
+    }
+
+    // 解码线程已缩放到显示尺寸的帧，以及尺寸变化前的旧帧（临时缩放的输入），先按 RGB32 生成再转换为各帧格式
+    QImage backingStore(widgetSize, QImage::Format_RGB32);
+    QImage sourceFrame(drawRect.size(), QImage::Format_RGB32);
+    QImage sourceStaleFrame(remoteSize, QImage::Format_RGB32);
+    uint32_t state = 1;
+    for (QImage* image : { &sourceFrame, &sourceStaleFrame })
+    {
+        for (int y = 0; y < image->height(); ++y)
+        {
+            QRgb* line = reinterpret_cast<QRgb*>(image->scanLine(y));
+            for (int x = 0; x < image->width(); ++x)
+            {
+                line[x] = 0xFF000000u | syntheticRandom(state);
+            }
+        }
+    }
+    QImage frame;
+    QImage staleFrame;
+
+    auto paintFull = [&]() {
+        QPainter painter(&backingStore);
+        painter.fillRect(backingStore.rect(), Qt::black);
+        QRect rect = deskLetterboxRect(widgetSize, remoteSize);
+        painter.drawImage(rect, frame);
+    };
+    auto paintOpaque = [&]() {
+        QPainter painter(&backingStore);
+        // onFrameAvailable 调用 update(m_drawRect)，刷新区域就是显示区域，黑边不在其中
+        QRect eventRect = drawRect;
+        for (const QRect& bar : QRegion(eventRect) - drawRect)
+        {
+            painter.fillRect(bar, Qt::black);
+        }
+        painter.drawImage(drawRect.topLeft(), frame);
+    };
+    auto paintScaled = [&](bool smooth) {
+        QPainter painter(&backingStore);
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, smooth);
+        painter.drawImage(drawRect, staleFrame);
+    };
+
+    out << QString("widget %1x%2, remote %3x%4, display rect %5x%6+%7+%8, %9 rounds")
+               .arg(widgetW).arg(widgetH).arg(remoteW).arg(remoteH)
+               .arg(drawRect.width()).arg(drawRect.height()).arg(drawRect.x()).arg(drawRect.y())
+               .arg(rounds) << "\n";
+
+    struct Path { const char* name; std::function<void()> paint; };
+    const Path paths[] = {
+        { "full", paintFull },
+        { "opaque", paintOpaque },
+        { "smooth", [&]() { paintScaled(true); } },
+        { "fast", [&]() { paintScaled(false); } }
+    };
+    for (const SourceFormat& source : SOURCE_FORMATS)
+    {
+        frame = sourceFrame.convertToFormat(source.format);
+        staleFrame = sourceStaleFrame.convertToFormat(source.format);
+        for (const Path& path : paths)
+        {
+            path.paint();
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < rounds; ++i)
+            {
+                path.paint();
+            }
+            out << QString("%1 %2: %3 us/frame").arg(source.name).arg(path.name)
+                       .arg(timer.nsecsElapsed() / 1000 / rounds) << "\n";
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+# MultimediaVideoOutput 写日志，需要一起链接日志窗口
+TARGET = bench_present
+
+include(../bench.pri)
+
+QT += widgets multimedia multimediawidgets
+
+HEADERS += \
+    $$SRC_DIR/DeskDefine.h \
+    $$SRC_DIR/FrameMailbox.h \
+    $$SRC_DIR/LogWidget.h \
+    $$SRC_DIR/MultimediaVideoOutput.h \
+    $$SRC_DIR/StreamStats.h \
+    $$SRC_DIR/YuvConverter.h
+
+SOURCES += \
+    main.cpp \
+    $$SRC_DIR/LogWidget.cpp \
+    $$SRC_DIR/MultimediaVideoOutput.cpp \
+    $$SRC_DIR/StreamStats.cpp \
+    $$SRC_DIR/YuvConverter.cpp
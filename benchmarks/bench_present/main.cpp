@@ -0,0 +1,147 @@
+#include <QApplication>
+#include <QElapsedTimer>
+#include <QImage>
+#include <QPainter>
+#include <QStringList>
+#include <QTextStream>
+#include <QVideoWidget>
+#include <QWidget>
+
+#include "DeskDefine.h"
+#include "MultimediaVideoOutput.h"
+#include "StreamStats.h"
+#include "SyntheticFrame.h"
+#include "YuvConverter.h"
+
+#include <functional>
+
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+// 光栅路径的显示控件: 与 VideoWidget 一样把转换好的 QImage 1:1 画到显示区域
+class RasterView : public QWidget
+{
+public:
+    QImage image;
+
+protected:
+    void paintEvent(QPaintEvent*) override
+    {
+        QPainter painter(this);
+        painter.drawImage(0, 0, image);
+    }
+};
+
+// 每显示一帧的进程 CPU 时间和墙钟时间，开始计时前先预热几帧
+static void measure(const char* name, int frames, const std::function<void()>& showFrame, QTextStream& out)
+{
+    for (int i = 0; i < 10; ++i)
+    {
+        showFrame();
+    }
+    qint64 cpuStart = StreamStats::processCpuNs();
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < frames; ++i)
+    {
+        showFrame();
+    }
+    qint64 wallNs = timer.nsecsElapsed();
+    qint64 cpuNs = StreamStats::processCpuNs() - cpuStart;
+    out << QString("%1: %2 us CPU/frame, %3 us wall/frame")
+               .arg(name).arg(cpuNs / 1000 / frames).arg(wallNs / 1000 / frames) << "\n";
+    out.flush();
+}
+
+// 显示一帧解码输出的两种方式，比较整个进程的 CPU 开销
+//   raster:     解码线程转换（同尺寸用 YuvConverter，否则 sws_scale）为 QImage，再由 QPainter 绘制
+//   multimedia: AVFrame 包装成 QVideoFrame 不拷贝，交给 QVideoWidget 的平台渲染路径
+// 两种方式都在同一个线程上完成，CPU 时间包括窗口系统的绘制
+// 用法: bench_present [显示WxH] [远端WxH] [帧数] [nv12]，需要窗口系统
+int main(int argc, char* argv[])
+{
+    QApplication app(argc, argv);
+    QTextStream out(stdout);
+    QStringList args = app.arguments();
+
+    int displayW = 1920;
+    int displayH = 1080;
+    int remoteW = 1920;
+    int remoteH = 1080;
+    if (args.size() > 1)
+    {
+        parseSyntheticSize(args[1].toLatin1().constData(), displayW, displayH);
+    }
+    if (args.size() > 2)
+    {
+        parseSyntheticSize(args[2].toLatin1().constData(), remoteW, remoteH);
+    }
+    int frames = qMax(1, args.size() > 3 ? args[3].toInt() : 300);
+    AVPixelFormat format = args.size() > 4 && args[4] == "nv12" ? AV_PIX_FMT_NV12 : AV_PIX_FMT_YUV420P;
+
+    QRect drawRect = deskLetterboxRect(QSize(displayW, displayH), QSize(remoteW, remoteH));
+    AVFrame* source = allocSyntheticFrame(remoteW, remoteH, format);
+    if (drawRect.isEmpty() || !source)
+    {
+        out << "Could not allocate frames\n";
+        return 1;
+    }
+    fillDesktopFrame(source, 1);
+    out << QString("display %1x%2, remote %3x%4 %5, %6 frames")
+               .arg(drawRect.width()).arg(drawRect.height()).arg(remoteW).arg(remoteH)
+               .arg(format == AV_PIX_FMT_NV12 ? "nv12" : "yuv420p").arg(frames) << "\n";
+
+    {
+        RasterView view;
+        view.resize(drawRect.size());
+        view.show();
+        view.image = QImage(drawRect.size(), QImage::Format_RGB32);
+        YuvConverter converter(YuvConverter::bestKernel());
+        bool sameSize = drawRect.size() == QSize(remoteW, remoteH);
+        bool useKernel = sameSize && YuvConverter::supports(source, AV_PIX_FMT_RGB32);
+        SwsContext* swsCtx = sws_getContext(remoteW, remoteH, format, drawRect.width(), drawRect.height(),
+                                            AV_PIX_FMT_RGB32, SWS_BILINEAR, nullptr, nullptr, nullptr);
+        measure(useKernel ? "raster (YuvConverter)" : "raster (sws_scale)", frames, [&]() {
+            uint8_t* bits = view.image.bits();
+            if (useKernel)
+            {
+                converter.convert(source, AV_PIX_FMT_RGB32, bits, static_cast<int>(view.image.bytesPerLine()),
+                                  0, remoteH);
+            }
+            else if (swsCtx)
+            {
+                uint8_t* destData[4] = { bits, nullptr, nullptr, nullptr };
+                int destLinesize[4] = { static_cast<int>(view.image.bytesPerLine()), 0, 0, 0 };
+                sws_scale(swsCtx, source->data, source->linesize, 0, remoteH, destData, destLinesize);
+            }
+            view.repaint();
+            QCoreApplication::processEvents();
+        }, out);
+        sws_freeContext(swsCtx);
+    }
+
+    {
+        QVideoWidget view;
+        view.resize(drawRect.size());
+        view.show();
+        MultimediaVideoOutput output(&view);
+        bool ok = true;
+        measure("multimedia", frames, [&]() {
+            // 与解码线程发布的一样，每帧是解码输出的一个新引用
+            VideoFrame frame;
+            frame.yuv.reset(av_frame_clone(source), [](AVFrame* f) { av_frame_free(&f); });
+            frame.sourceSize = QSize(remoteW, remoteH);
+            ok = output.present(frame) && ok;
+            view.repaint();
+            QCoreApplication::processEvents();
+        }, out);
+        if (!ok)
+        {
+            out << "multimedia: surface rejected the frame format, numbers are not meaningful\n";
+        }
+    }
+
+    av_frame_free(&source);
+    return 0;
+}
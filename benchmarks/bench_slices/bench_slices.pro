@@ -0,0 +1,12 @@
+TARGET = bench_slices
+
+include(../bench.pri)
+
+HEADERS += \
+    $$SRC_DIR/SliceThreadPool.h \
+    $$SRC_DIR/YuvConverter.h
+
+SOURCES += \
+    main.cpp \
+    $$SRC_DIR/SliceThreadPool.cpp \
+    $$SRC_DIR/YuvConverter.cpp
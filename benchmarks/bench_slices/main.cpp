@@ -0,0 +1,124 @@
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QTextStream>
+#include <QVector>
+
+#include "SliceThreadPool.h"
+#include "YuvConverter.h"
+#include "SyntheticFrame.h"
+
+extern "C" {
+#include <libswscale/swscale.h>
+}
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+// 与 VideoDecoderWorker 相同: 每个参与线程分到的切片数
+#define SLICES_PER_THREAD 4
+
+// 色彩转换按切片并行的加速比曲线（1..N 线程）
+// 分别测量 SIMD 专用内核和每切片一个 SwsContext 的 sws_scale 两条路径。
+// 用法: bench_slices [WxH] [线程数] [轮数]
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    QTextStream out(stdout);
+
+    int width = 1920;
+    int height = 1080;
+    QStringList args = app.arguments();
+    if (args.size() > 1)
+    {
+        parseSyntheticSize(args[1].toLatin1().constData(), width, height);
+    }
+    int maxThreads = args.size() > 2 ? args[2].toInt() : QThread::idealThreadCount();
+    int rounds = args.size() > 3 ? args[3].toInt() : 50;
+    maxThreads = qMax(1, maxThreads);
+    rounds = qMax(1, rounds);
+
+    AVFrame* frame = allocSyntheticFrame(width, height, AV_PIX_FMT_YUV420P);
+    if (!frame)
+    {
+        out << "Could not allocate frame\n";
+        return 1;
+    }
+    fillDesktopFrame(frame, 1);
+
+    int dstStride = (width * 4 + 31) & ~31;
+    std::vector<uint8_t> dst(static_cast<size_t>(dstStride) * height);
+    SliceThreadPool pool(maxThreads - 1);
+    YuvConverter converter;
+
+    // 切片行数对齐到色度行
+    int sliceCount = pool.maxThreads() * SLICES_PER_THREAD;
+    int sliceRows = ((height + sliceCount - 1) / sliceCount + 1) & ~1;
+    sliceCount = (height + sliceRows - 1) / sliceRows;
+    QVector<SwsContext*> swsContexts(sliceCount, nullptr);
+
+    auto yuvTask = [&](int slice) {
+        int rowBegin = slice * sliceRows;
+        int rowEnd = qMin(rowBegin + sliceRows, height);
+        converter.convert(frame, AV_PIX_FMT_BGRA, dst.data(), dstStride, rowBegin, rowEnd);
+    };
+    std::atomic<bool> swsOk{true};
+    auto swsTask = [&](int slice) {
+        int rowBegin = slice * sliceRows;
+        int rows = qMin(sliceRows, height - rowBegin);
+        SwsContext*& ctx = swsContexts[slice];
+        ctx = sws_getCachedContext(ctx, width, rows, AV_PIX_FMT_YUV420P, width, rows, AV_PIX_FMT_BGRA,
+                                   SWS_BILINEAR, nullptr, nullptr, nullptr);
+        if (!ctx)
+        {
+            swsOk = false;
+            return;
+        }
+        const uint8_t* src[4] = { frame->data[0] + rowBegin * frame->linesize[0],
+                                  frame->data[1] + (rowBegin / 2) * frame->linesize[1],
+                                  frame->data[2] + (rowBegin / 2) * frame->linesize[2], nullptr };
+        uint8_t* dstData[4] = { dst.data() + rowBegin * dstStride, nullptr, nullptr, nullptr };
+        int dstLinesize[4] = { dstStride, 0, 0, 0 };
+        sws_scale(ctx, src, frame->linesize, 0, rows, dstData, dstLinesize);
+    };
+
+    out << QString("%1x%2, %3 slices of %4 rows, %5 rounds, cores %6")
+               .arg(width).arg(height).arg(sliceCount).arg(sliceRows).arg(rounds)
+               .arg(QThread::idealThreadCount()) << "\n";
+
+    struct Path { const char* name; std::function<void(int)> task; };
+    const Path paths[] = {
+        { YuvConverter::kernelName(converter.kernel()), yuvTask },
+        { "sws", swsTask }
+    };
+    for (const Path& path : paths)
+    {
+        qint64 singleNs = 0;
+        for (int threads = 1; threads <= pool.maxThreads(); ++threads)
+        {
+            // 先跑一轮预热（sws 在这里创建上下文）
+            pool.run(sliceCount, path.task, threads);
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < rounds; ++i)
+            {
+                pool.run(sliceCount, path.task, threads);
+            }
+            qint64 ns = timer.nsecsElapsed() / rounds;
+            if (threads == 1)
+            {
+                singleNs = ns;
+            }
+            out << QString("%1 %2T: %3 us/frame (x%4)").arg(path.name).arg(threads).arg(ns / 1000)
+                       .arg(ns > 0 ? double(singleNs) / ns : 0.0, 0, 'f', 2) << "\n";
+        }
+    }
+
+    for (SwsContext* ctx : swsContexts)
+    {
+        sws_freeContext(ctx);
+    }
+    av_frame_free(&frame);
+    return swsOk ? 0 : 1;
+}
@@ -0,0 +1,14 @@
+# 性能基准，与 src/DeskControler.pro 独立构建，不进入发布包:
+#   qmake benchmarks/benchmarks.pro && make
+# 各基准的用法见对应 main.cpp 开头的说明
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    bench_slices \
+    bench_nalscan \
+    bench_decode \
+    bench_jitter \
+    bench_paint \
+    bench_present \
+    bench_blockhash
@@ -0,0 +1,36 @@
+#ifndef RECORDEDSTREAM_H
+#define RECORDEDSTREAM_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <QVector>
+#include <QtEndian>
+
+// 读出 StreamRecorder 录制文件（4 字节大端长度 + 消息）中的全部消息
+// 与 StreamRecorder::readAll 相同，不把日志窗口链接进基准程序
+inline bool readRecordedStream(const QString& path, QVector<QByteArray>& messages)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return false;
+    }
+    QByteArray content = file.readAll();
+    const uchar* data = reinterpret_cast<const uchar*>(content.constData());
+    int pos = 0;
+    while (pos + 4 <= content.size())
+    {
+        quint32 length = qFromBigEndian<quint32>(data + pos);
+        pos += 4;
+        if (length > quint32(content.size() - pos))
+        {
+            break;
+        }
+        messages.append(content.mid(pos, int(length)));
+        pos += int(length);
+    }
+    return !messages.isEmpty();
+}
+
+#endif // RECORDEDSTREAM_H
@@ -0,0 +1,133 @@
+#ifndef SYNTHETICFRAME_H
+#define SYNTHETICFRAME_H
+
+#include <cstdint>
+#include <cstdio>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+// 基准测试用的合成帧，不依赖录制文件也能复现
+// 内容模拟远程桌面: 大片纯色背景 + 成行的细碎"文字"块，色度在窗口之间变化
+
+// 分配 width x height 的 YUV420P/NV12 帧，失败时返回 nullptr
+inline AVFrame* allocSyntheticFrame(int width, int height, AVPixelFormat format)
+{
+    AVFrame* frame = av_frame_alloc();
+    if (!frame)
+    {
+        return nullptr;
+    }
+    frame->width = width;
+    frame->height = height;
+    frame->format = format;
+    // 32 字节对齐，与解码器输出的行距一致
+    if (av_frame_get_buffer(frame, 32) < 0)
+    {
+        av_frame_free(&frame);
+        return nullptr;
+    }
+    return frame;
+}
+
+// 线性同余，保证每次运行内容一致
+inline uint32_t syntheticRandom(uint32_t& state)
+{
+    state = state * 1664525u + 1013904223u;
+    return state >> 8;
+}
+
+inline void setSyntheticChroma(AVFrame* frame, int cx, int cy, uint8_t u, uint8_t v)
+{
+    if (frame->format == AV_PIX_FMT_NV12)
+    {
+        uint8_t* uv = frame->data[1] + cy * frame->linesize[1] + cx * 2;
+        uv[0] = u;
+        uv[1] = v;
+    }
+    else
+    {
+        frame->data[1][cy * frame->linesize[1] + cx] = u;
+        frame->data[2][cy * frame->linesize[2] + cx] = v;
+    }
+}
+
+// 填充桌面样式的内容
+inline void fillDesktopFrame(AVFrame* frame, uint32_t seed)
+{
+    uint32_t state = seed;
+    int width = frame->width;
+    int height = frame->height;
+
+    // 背景: 亮色窗口区域，左侧 1/4 是深色侧栏
+    for (int y = 0; y < height; ++y)
+    {
+        uint8_t* row = frame->data[0] + y * frame->linesize[0];
+        for (int x = 0; x < width; ++x)
+        {
+            row[x] = x < width / 4 ? 48 : 224;
+        }
+    }
+    for (int cy = 0; cy < (height + 1) / 2; ++cy)
+    {
+        for (int cx = 0; cx < (width + 1) / 2; ++cx)
+        {
+            bool sidebar = cx * 2 < width / 4;
+            setSyntheticChroma(frame, cx, cy, sidebar ? 140 : 128, sidebar ? 120 : 128);
+        }
+    }
+
+    // 文字行: 每 20 行一行字，字符 8x12，笔画是随机的深色像素
+    for (int line = 8; line + 12 < height; line += 20)
+    {
+        int x = 16 + static_cast<int>(syntheticRandom(state) % 64);
+        int end = width - 16 - static_cast<int>(syntheticRandom(state) % (width / 2 + 1));
+        for (; x + 8 < end; x += 8)
+        {
+            if (syntheticRandom(state) % 6 == 0)
+            {
+                continue; // 空格
+            }
+            for (int y = line; y < line + 12; ++y)
+            {
+                uint8_t* row = frame->data[0] + y * frame->linesize[0];
+                for (int i = 1; i < 7; ++i)
+                {
+                    if (syntheticRandom(state) % 3 == 0)
+                    {
+                        row[x + i] = x < width / 4 ? 200 : 40;
+                    }
+                }
+            }
+        }
+    }
+}
+
+// 模拟一次局部更新: 在 (x, y) 处重画 w x h 的区域（光标闪烁、输入文字等）
+inline void touchSyntheticRegion(AVFrame* frame, int x, int y, int w, int h, uint32_t seed)
+{
+    uint32_t state = seed;
+    for (int row = y; row < y + h && row < frame->height; ++row)
+    {
+        uint8_t* line = frame->data[0] + row * frame->linesize[0];
+        for (int col = x; col < x + w && col < frame->width; ++col)
+        {
+            line[col] = static_cast<uint8_t>(16 + syntheticRandom(state) % 220);
+        }
+    }
+}
+
+// 命令行参数里的 WxH，格式不对时保留默认值
+inline void parseSyntheticSize(const char* text, int& width, int& height)
+{
+    int w = 0;
+    int h = 0;
+    if (text && std::sscanf(text, "%dx%d", &w, &h) == 2 && w > 0 && h > 0)
+    {
+        width = w;
+        height = h;
+    }
+}
+
+#endif // SYNTHETICFRAME_H
@@ -0,0 +1,150 @@
+#include "AccessUnitAssembler.h"
+#include "H264Nal.h"
+#include "StreamParser.h"
+#include "LogWidget.h"
+
+AccessUnitAssembler::AccessUnitAssembler(DeskAccessUnitMode mode, DeskVideoCodec codec)
+    : m_mode(mode)
+    , m_codec(codec)
+    , m_configuredCodec(codec)
+{
+}
+
+void AccessUnitAssembler::reset()
+{
+    m_pending.clear();
+    m_pendingHasVcl = false;
+}
+
+void AccessUnitAssembler::restart()
+{
+    reset();
+    m_codec = m_configuredCodec;
+}
+
+void AccessUnitAssembler::emitUnit(const QByteArray& message, int begin, int end,
+                                   int firstNal, int lastNal, QVector<AccessUnit>& units)
+{
+    AccessUnit unit;
+    if (m_pending.isEmpty()) {
+        // 整条消息就是一个单元时直接共享，不拷贝
+        unit.data = begin == 0 && end == message.size() ? message : message.mid(begin, end - begin);
+        // 复用整条消息的索引，只平移偏移量
+        unit.nals.reserve(lastNal - firstNal);
+        for (int i = firstNal; i < lastNal; ++i) {
+            NalUnit nal = m_index.at(i);
+            nal.offset -= begin;
+            unit.nals.append(nal);
+        }
+        units.append(unit);
+        return;
+    }
+
+    // 跨消息拼接时 NAL 本身也可能被截断，拼好后重新索引（只在分片码流上发生）
+    m_pending.append(message.constData() + begin, end - begin);
+    unit.data = m_pending;
+    indexH264Nals(reinterpret_cast<const uint8_t*>(unit.data.constData()), unit.data.size(), unit.nals);
+    units.append(unit);
+    m_pending.clear();
+    m_pendingHasVcl = false;
+    ++m_merged;
+}
+
+void AccessUnitAssembler::push(const QByteArray& message, QVector<AccessUnit>& units)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(message.constData());
+    int size = message.size();
+
+    // 协议里没有编码格式字段，未配置时按第一条可识别的消息确定
+    if (m_codec == VIDEO_CODEC_AUTO) {
+        m_codec = sniffVideoCodec(data, size);
+        if (m_codec == VIDEO_CODEC_AUTO) {
+            return;
+        }
+        LogWidget::instance()->addLog(QString("Detected video codec: %1").arg(videoCodecName(m_codec)),
+                                      LogWidget::Info);
+    }
+
+    // 其它格式按每条消息一帧处理，只建立索引
+    if (m_codec != VIDEO_CODEC_H264) {
+        AccessUnit unit;
+        unit.data = message;
+        unit.codec = m_codec;
+        indexStreamUnits(m_codec, data, size, unit.nals);
+        units.append(unit);
+        return;
+    }
+
+    // 起始码被拆在两条消息之间时，把等待中数据末尾的 0 挪到本条消息前面，起始码才能完整识别。
+    // 完整的 NAL 以 rbsp 停止位结尾，末尾是 0 的几乎只有被截断的数据，平时不拷贝
+    if (!m_pending.isEmpty() && m_pending.endsWith('\0')) {
+        int zeros = 1;
+        while (zeros < 3 && zeros < m_pending.size() && m_pending.at(m_pending.size() - 1 - zeros) == 0) {
+            ++zeros;
+        }
+        QByteArray joined = m_pending.right(zeros) + message;
+        m_pending.chop(zeros);
+        pushH264(joined, units);
+        return;
+    }
+    pushH264(message, units);
+}
+
+void AccessUnitAssembler::pushH264(const QByteArray& message, QVector<AccessUnit>& units)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(message.constData());
+    int size = message.size();
+    int unitBegin = 0;
+    int unitNal = 0;
+    int emitted = 0;
+    bool hasVcl = m_pendingHasVcl;
+
+    // 整条消息只扫描一次起始码，拆出的各单元共用这份索引
+    indexH264Nals(data, size, m_index);
+
+    for (int k = 0; k < m_index.size(); ++k) {
+        const NalUnit& nal = m_index.at(k);
+        int pos = nal.offset - 3;
+        int type = nal.type;
+
+        // 当前单元已有片时，以下 NAL 开始新的单元（H.264 7.4.1.2.3 的简化判断）
+        bool boundary = false;
+        if (isH264VclNal(type)) {
+            boundary = hasVcl && (m_mode == AU_MODE_SLICE
+                                  || (nal.size > 1 && isH264FirstSliceOfPicture(data[nal.offset + 1])));
+        } else if (type == H264_NAL_AUD || type == H264_NAL_SPS || type == H264_NAL_PPS
+                   || type == H264_NAL_SEI || (type >= 14 && type <= 18)) {
+            boundary = hasVcl;
+        }
+
+        if (boundary) {
+            // 四字节起始码的前导 0 留给下一个单元
+            int cut = (pos > unitBegin && data[pos - 1] == 0) ? pos - 1 : pos;
+            if (cut > unitBegin || !m_pending.isEmpty()) {
+                emitUnit(message, unitBegin, cut, unitNal, k, units);
+                ++emitted;
+            }
+            unitBegin = cut;
+            unitNal = k;
+            hasVcl = false;
+        }
+        if (isH264VclNal(type)) {
+            hasVcl = true;
+        }
+    }
+
+    // 消息末尾: 帧模式继续等待下一帧开始，其余模式认为当前单元已完整
+    if (unitBegin < size) {
+        if (m_mode == AU_MODE_FRAME || (m_mode == AU_MODE_SLICE && !hasVcl)) {
+            m_pending.append(message.constData() + unitBegin, size - unitBegin);
+            m_pendingHasVcl = hasVcl;
+        } else {
+            emitUnit(message, unitBegin, size, unitNal, m_index.size(), units);
+            ++emitted;
+        }
+    }
+
+    if (m_mode != AU_MODE_SLICE && emitted > 1) {
+        ++m_split;
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef ACCESSUNITASSEMBLER_H
+#define ACCESSUNITASSEMBLER_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "DeskDefine.h"
+#include "NalIndex.h"
+
+// H.264 访问单元（一帧的全部 NAL）组装器，位于网络分帧和解码之间
+// 按 NAL 头判断访问单元边界（AUD/SPS/PPS/SEI 或 first_mb_in_slice == 0 的片），
+// 把一条消息里的多帧拆开，把跨消息的一帧拼起来，保证送给解码器和包队列的是完整单元:
+//   AU_MODE_MESSAGE  消息末尾即单元末尾，只拆分不等待（零附加延迟），要求服务端每条消息都以完整的 NAL 结束
+//   AU_MODE_FRAME    等到下一帧开始才输出，可处理任意分片的码流（最多多一条消息的延迟）
+//   AU_MODE_SLICE    每个片单独输出，解码器按 AV_CODEC_FLAG2_CHUNKS 边到边解
+// HEVC/MJPEG 按每条消息一帧直接输出，只建立索引。
+// 只在网络线程使用，不加锁。
+class AccessUnitAssembler
+{
+public:
+    // codec 为 VIDEO_CODEC_AUTO 时根据第一条可识别的消息确定
+    explicit AccessUnitAssembler(DeskAccessUnitMode mode = AU_MODE_FRAME,
+                                 DeskVideoCodec codec = VIDEO_CODEC_AUTO);
+
+    // 输入一条网络消息，把已完整的单元（连同 NAL 索引）追加到 units
+    void push(const QByteArray& message, QVector<AccessUnit>& units);
+
+    // 丢弃尚未完整的数据
+    void reset();
+    // 新会话: 丢弃数据，编码格式恢复为构造时的配置（AUTO 时重新识别）
+    void restart();
+
+    DeskAccessUnitMode mode() const { return m_mode; }
+    DeskVideoCodec codec() const { return m_codec; }
+    int pendingBytes() const { return m_pending.size(); }
+    // 由多条消息拼成的单元数
+    quint64 mergedCount() const { return m_merged; }
+    // 含多个单元而被拆开的消息数
+    quint64 splitCount() const { return m_split; }
+
+private:
+    // 按访问单元边界拆分一条 H.264 消息
+    void pushH264(const QByteArray& message, QVector<AccessUnit>& units);
+    // 输出 message[begin, end)，其 NAL 为 m_index[firstNal, lastNal)
+    void emitUnit(const QByteArray& message, int begin, int end,
+                  int firstNal, int lastNal, QVector<AccessUnit>& units);
+
+    DeskAccessUnitMode m_mode;
+    DeskVideoCodec m_codec;
+    DeskVideoCodec m_configuredCodec;
+    QByteArray m_pending;          // 跨消息、尚未完整的单元
+    bool m_pendingHasVcl = false;  // m_pending 中已有片
+    NalIndex m_index;          // 当前消息的 NAL 索引，复用以免每条消息分配
+    quint64 m_merged = 0;
+    quint64 m_split = 0;
+};
+
+#endif // ACCESSUNITASSEMBLER_H
@@ -0,0 +1,393 @@
+#include "BlockHasher.h"
+
+#include <cstddef>
+#include <cstring>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define BLOCK_HAVE_X86 1
+#include <emmintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BLOCK_TARGET(x)
+#else
+#define BLOCK_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
+#if defined(__aarch64__) || (defined(__arm__) && defined(__ARM_NEON))
+#define BLOCK_HAVE_NEON 1
+#include <arm_neon.h>
+#if defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+// 每块 16 行亮度 + 8 行色度（YUV420P 为 U/V 各 8 字节拼成一行，NV12 为 16 字节 UV），每行 16 字节
+#define BLOCK_HASH_ROWS 24
+#define BLOCK_CHROMA_ROWS 8
+
+// 每行一个 128 位密钥，同样的内容出现在不同行时哈希不同
+static const uint64_t g_blockKeys[BLOCK_HASH_ROWS * 2] = {
+    0xc0e16b163a85a4dcULL, 0x890acd8dd443c47cULL,
+    0xb3889d8a6dc47761ULL, 0x6a0398e528f0ae6aULL,
+    0x048344ece48a855eULL, 0xf175cfea21871330ULL,
+    0x391ceef02702c2fdULL, 0x4baf8cac4784cb12ULL,
+    0x3547744583a3f88eULL, 0xd9cf2b15c6b6c90eULL,
+    0x961facc76d5fe21cULL, 0x0094ab49d50f11f9ULL,
+    0xe3211e37bdbeb6dcULL, 0x62fe6c274ff3511aULL,
+    0x5ac30b329fdf0574ULL, 0x1450582c6b65b406ULL,
+    0x7a30fcc7888eb791ULL, 0x5540f5ba6a15576eULL,
+    0x16cef0559096d3e9ULL, 0x2cf8f14b06874899ULL,
+    0xc9c9263b6e2ce103ULL, 0xd6ff920b0a9faa6dULL,
+    0x53192697db998dc1ULL, 0x73ea9b9bc7cd18d7ULL,
+    0x102713f872c33fceULL, 0xf4183a0e5d2a033eULL,
+    0x71b63e307eebb517ULL, 0xda61f5713d036000ULL,
+    0x46eb7409ae691b21ULL, 0xb23ad691d6707698ULL,
+    0x67c8fe11d22fc4b9ULL, 0x7eb4661419481338ULL,
+    0x98077547fb070efcULL, 0x1ee63336c2e3a9a8ULL,
+    0xbc353656348c36f6ULL, 0xce3898cbf1bb1bd8ULL,
+    0x265b1c23c82915cbULL, 0xfd1948c91687e355ULL,
+    0xd976893961980ffaULL, 0x336e77a6288e4c34ULL,
+    0x16f8956d7b76d269ULL, 0xda7cd844690d4669ULL,
+    0x1e8cf85f253a581eULL, 0x3ea68129e923e53aULL,
+    0xa080a077c9e9fd79ULL, 0x4469a19c673c14cfULL,
+    0xbd5b9351b2d0963cULL, 0xb46a749cad9df6b7ULL,
+};
+
+// 整块哈希: 从块左上角开始，色度指针指向对应的 8x8 区域
+typedef uint64_t (*BlockHashFunc)(const uint8_t* y, int strideY,
+                                  const uint8_t* u, int strideU,
+                                  const uint8_t* v, int strideV, bool nv12);
+
+// 两个 64 位累加器合成一个哈希
+static inline uint64_t finishHash(uint64_t lane0, uint64_t lane1)
+{
+    return lane0 ^ (lane1 * 0x9E3779B97F4A7C15ULL);
+}
+
+// ==========================================
+// 标量参考实现
+// ==========================================
+// 每行 16 字节看作两个 64 位数: 与密钥异或后高低 32 位相乘累加到本路，原始数据累加到另一路
+// （与 XXH3 的累加步骤相同，两条路都能映射到 SIMD 的 32x32->64 乘法）
+static inline void accumulateScalar(uint64_t acc[2], const uint8_t* data, const uint64_t* key)
+{
+    uint64_t words[2];
+    memcpy(words, data, sizeof(words));
+    for (int i = 0; i < 2; ++i)
+    {
+        uint64_t mixed = words[i] ^ key[i];
+        acc[i] += (mixed & 0xFFFFFFFFULL) * (mixed >> 32);
+        acc[i ^ 1] += words[i];
+    }
+}
+
+static uint64_t hashBlockScalar(const uint8_t* y, int strideY,
+                                const uint8_t* u, int strideU,
+                                const uint8_t* v, int strideV, bool nv12)
+{
+    uint64_t acc[2] = { 0, 0 };
+    for (int row = 0; row < BlockHasher::BLOCK_SIZE; ++row)
+    {
+        accumulateScalar(acc, y + row * strideY, g_blockKeys + row * 2);
+    }
+    for (int row = 0; row < BLOCK_CHROMA_ROWS; ++row)
+    {
+        const uint64_t* key = g_blockKeys + (BlockHasher::BLOCK_SIZE + row) * 2;
+        if (nv12)
+        {
+            accumulateScalar(acc, u + row * strideU, key);
+        }
+        else
+        {
+            uint8_t line[16];
+            memcpy(line, u + row * strideU, 8);
+            memcpy(line + 8, v + row * strideV, 8);
+            accumulateScalar(acc, line, key);
+        }
+    }
+    return finishHash(acc[0], acc[1]);
+}
+
+// ==========================================
+// x86: SSE2
+// ==========================================
+#ifdef BLOCK_HAVE_X86
+
+BLOCK_TARGET("sse2")
+static inline __m128i accumulateSSE2(__m128i acc, __m128i data, const uint64_t* key)
+{
+    __m128i mixed = _mm_xor_si128(data, _mm_loadu_si128(reinterpret_cast<const __m128i*>(key)));
+    __m128i product = _mm_mul_epu32(mixed, _mm_srli_epi64(mixed, 32));
+    __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+    return _mm_add_epi64(acc, _mm_add_epi64(product, swapped));
+}
+
+BLOCK_TARGET("sse2")
+static uint64_t hashBlockSSE2(const uint8_t* y, int strideY,
+                              const uint8_t* u, int strideU,
+                              const uint8_t* v, int strideV, bool nv12)
+{
+    __m128i acc = _mm_setzero_si128();
+    for (int row = 0; row < BlockHasher::BLOCK_SIZE; ++row)
+    {
+        __m128i data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + row * strideY));
+        acc = accumulateSSE2(acc, data, g_blockKeys + row * 2);
+    }
+    for (int row = 0; row < BLOCK_CHROMA_ROWS; ++row)
+    {
+        __m128i data;
+        if (nv12)
+        {
+            data = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + row * strideU));
+        }
+        else
+        {
+            data = _mm_unpacklo_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + row * strideU)),
+                                      _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + row * strideV)));
+        }
+        acc = accumulateSSE2(acc, data, g_blockKeys + (BlockHasher::BLOCK_SIZE + row) * 2);
+    }
+
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return finishHash(lanes[0], lanes[1]);
+}
+
+static bool cpuSupportsSSE2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+#endif // BLOCK_HAVE_X86
+
+// ==========================================
+// ARM: NEON
+// ==========================================
+#ifdef BLOCK_HAVE_NEON
+
+static inline uint64x2_t accumulateNEON(uint64x2_t acc, uint8x16_t bytes, const uint64_t* key)
+{
+    uint64x2_t data = vreinterpretq_u64_u8(bytes);
+    uint64x2_t mixed = veorq_u64(data, vld1q_u64(key));
+    uint64x2_t product = vmull_u32(vmovn_u64(mixed), vshrn_n_u64(mixed, 32));
+    uint64x2_t swapped = vextq_u64(data, data, 1);
+    return vaddq_u64(acc, vaddq_u64(product, swapped));
+}
+
+static uint64_t hashBlockNEON(const uint8_t* y, int strideY,
+                              const uint8_t* u, int strideU,
+                              const uint8_t* v, int strideV, bool nv12)
+{
+    uint64x2_t acc = vdupq_n_u64(0);
+    for (int row = 0; row < BlockHasher::BLOCK_SIZE; ++row)
+    {
+        acc = accumulateNEON(acc, vld1q_u8(y + row * strideY), g_blockKeys + row * 2);
+    }
+    for (int row = 0; row < BLOCK_CHROMA_ROWS; ++row)
+    {
+        uint8x16_t data = nv12 ? vld1q_u8(u + row * strideU)
+                               : vcombine_u8(vld1_u8(u + row * strideU), vld1_u8(v + row * strideV));
+        acc = accumulateNEON(acc, data, g_blockKeys + (BlockHasher::BLOCK_SIZE + row) * 2);
+    }
+    return finishHash(vgetq_lane_u64(acc, 0), vgetq_lane_u64(acc, 1));
+}
+
+static bool cpuSupportsNEON()
+{
+#if defined(__aarch64__)
+    return true;
+#elif defined(__linux__)
+    // HWCAP_NEON
+    return (getauxval(AT_HWCAP) & (1 << 12)) != 0;
+#else
+    return true;
+#endif
+}
+
+#endif // BLOCK_HAVE_NEON
+
+static BlockHashFunc selectHashFunc(BlockHasher::Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef BLOCK_HAVE_X86
+    case BlockHasher::KernelSSE2:
+        return &hashBlockSSE2;
+#endif
+#ifdef BLOCK_HAVE_NEON
+    case BlockHasher::KernelNEON:
+        return &hashBlockNEON;
+#endif
+    default:
+        return &hashBlockScalar;
+    }
+}
+
+BlockHasher::BlockHasher()
+    : m_kernel(bestKernel())
+{
+}
+
+BlockHasher::BlockHasher(Kernel kernel)
+    : m_kernel(isKernelSupported(kernel) ? kernel : KernelScalar)
+{
+}
+
+bool BlockHasher::isKernelSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case KernelScalar:
+        return true;
+#ifdef BLOCK_HAVE_X86
+    case KernelSSE2:
+        return cpuSupportsSSE2();
+#endif
+#ifdef BLOCK_HAVE_NEON
+    case KernelNEON:
+        return cpuSupportsNEON();
+#endif
+    default:
+        return false;
+    }
+}
+
+BlockHasher::Kernel BlockHasher::bestKernel()
+{
+    static const Kernel best = []() {
+        const Kernel order[] = { KernelSSE2, KernelNEON };
+        for (Kernel kernel : order)
+        {
+            if (isKernelSupported(kernel))
+            {
+                return kernel;
+            }
+        }
+        return KernelScalar;
+    }();
+    return best;
+}
+
+const char* BlockHasher::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case KernelSSE2:
+        return "sse2";
+    case KernelNEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+bool BlockHasher::supports(const AVFrame* frame)
+{
+    return frame && (frame->format == AV_PIX_FMT_YUV420P || frame->format == AV_PIX_FMT_YUVJ420P
+                     || frame->format == AV_PIX_FMT_NV12);
+}
+
+void BlockHasher::reset()
+{
+    m_hashes.clear();
+    m_size = QSize();
+    m_format = -1;
+}
+
+int BlockHasher::update(const AVFrame* frame)
+{
+    QSize size(frame->width, frame->height);
+    bool nv12 = frame->format == AV_PIX_FMT_NV12;
+    bool compare = !m_hashes.empty() && size == m_size && frame->format == m_format;
+    if (!compare)
+    {
+        m_size = size;
+        m_format = frame->format;
+        m_columns = (size.width() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        m_rows = (size.height() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+        m_hashes.assign(static_cast<size_t>(m_columns) * m_rows, 0);
+        m_changed.assign(m_hashes.size(), 1);
+    }
+
+    BlockHashFunc hashBlock = selectHashFunc(m_kernel);
+    const int chromaBlock = BLOCK_SIZE / 2;
+    int changedBlocks = 0;
+    m_changedPixels = 0;
+
+    for (int by = 0; by < m_rows; ++by)
+    {
+        int top = by * BLOCK_SIZE;
+        int height = qMin(BLOCK_SIZE, size.height() - top);
+        for (int bx = 0; bx < m_columns; ++bx)
+        {
+            int left = bx * BLOCK_SIZE;
+            int width = qMin(BLOCK_SIZE, size.width() - left);
+
+            const uint8_t* y = frame->data[0] + static_cast<ptrdiff_t>(top) * frame->linesize[0] + left;
+            const uint8_t* u = frame->data[1] + static_cast<ptrdiff_t>(top / 2) * frame->linesize[1]
+                               + (nv12 ? left : left / 2);
+            const uint8_t* v = nv12 ? nullptr
+                                    : frame->data[2] + static_cast<ptrdiff_t>(top / 2) * frame->linesize[2] + left / 2;
+
+            uint64_t hash;
+            if (width == BLOCK_SIZE && height == BLOCK_SIZE)
+            {
+                hash = hashBlock(y, frame->linesize[0], u, frame->linesize[1],
+                                 v, nv12 ? 0 : frame->linesize[2], nv12);
+            }
+            else
+            {
+                // 右/下边缘的不完整块补零后按整块计算，避免读出平面之外
+                uint8_t padY[BLOCK_SIZE * BLOCK_SIZE] = {};
+                uint8_t padU[chromaBlock * BLOCK_SIZE] = {};
+                uint8_t padV[chromaBlock * chromaBlock] = {};
+                int chromaWidth = (width + 1) / 2;
+                int chromaHeight = (height + 1) / 2;
+                for (int row = 0; row < height; ++row)
+                {
+                    memcpy(padY + row * BLOCK_SIZE, y + static_cast<ptrdiff_t>(row) * frame->linesize[0], width);
+                }
+                for (int row = 0; row < chromaHeight; ++row)
+                {
+                    if (nv12)
+                    {
+                        memcpy(padU + row * BLOCK_SIZE, u + static_cast<ptrdiff_t>(row) * frame->linesize[1],
+                               chromaWidth * 2);
+                    }
+                    else
+                    {
+                        memcpy(padU + row * chromaBlock, u + static_cast<ptrdiff_t>(row) * frame->linesize[1],
+                               chromaWidth);
+                        memcpy(padV + row * chromaBlock, v + static_cast<ptrdiff_t>(row) * frame->linesize[2],
+                               chromaWidth);
+                    }
+                }
+                hash = hashBlock(padY, BLOCK_SIZE, padU, nv12 ? BLOCK_SIZE : chromaBlock,
+                                 padV, chromaBlock, nv12);
+            }
+
+            size_t index = static_cast<size_t>(by) * m_columns + bx;
+            bool changed = !compare || hash != m_hashes[index];
+            m_hashes[index] = hash;
+            m_changed[index] = changed ? 1 : 0;
+            if (changed)
+            {
+                ++changedBlocks;
+                m_changedPixels += width * height;
+            }
+        }
+    }
+    return changedBlocks;
+}
@@ -0,0 +1,63 @@
+#ifndef BLOCKHASHER_H
+#define BLOCKHASHER_H
+
+#include <QSize>
+#include <cstdint>
+#include <vector>
+
+struct AVFrame;
+
+// 逐块比较相邻两帧的解码输出
+// 远程桌面大部分时间画面静止，按 16x16 亮度块（连同对应的 8x8 色度）计算 64 位哈希，
+// 与上一帧同位置的哈希比较，只有变化的块才需要转换和重绘，整帧不变时可以整帧跳过。
+// 解码器的帧缓冲会被复用，不能留着上一帧直接比较像素，所以每块只保存哈希。
+// 标量参考实现 + SSE2(x86) + NEON(ARM)，各内核结果逐位一致。
+// 仅支持 YUV420P/YUVJ420P/NV12。
+class BlockHasher
+{
+public:
+    enum Kernel
+    {
+        KernelScalar = 0,
+        KernelSSE2,
+        KernelNEON
+    };
+
+    static const int BLOCK_SIZE = 16;
+
+    BlockHasher();
+    explicit BlockHasher(Kernel kernel);
+
+    static Kernel bestKernel();
+    static bool isKernelSupported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+
+    Kernel kernel() const { return m_kernel; }
+
+    static bool supports(const AVFrame* frame);
+
+    // 计算 frame 各块的哈希并与上一次 update 比较，返回变化的块数
+    // 尺寸或格式与上一次不同、或 reset() 之后，所有块都算变化
+    int update(const AVFrame* frame);
+    // 丢弃保存的哈希，下一帧整帧算变化
+    void reset();
+
+    int columns() const { return m_columns; }
+    int rows() const { return m_rows; }
+    int blockCount() const { return m_columns * m_rows; }
+    bool isChanged(int column, int row) const { return m_changed[row * m_columns + column] != 0; }
+    // 最近一次 update 中变化块覆盖的像素数（边缘块按实际尺寸计）
+    qint64 changedPixels() const { return m_changedPixels; }
+
+private:
+    Kernel m_kernel = KernelScalar;
+    QSize m_size;
+    int m_format = -1;
+    int m_columns = 0;
+    int m_rows = 0;
+    std::vector<uint64_t> m_hashes;
+    std::vector<uint8_t> m_changed;
+    qint64 m_changedPixels = 0;
+};
+
+#endif // BLOCKHASHER_H
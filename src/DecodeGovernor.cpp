@@ -0,0 +1,80 @@
+#include "DecodeGovernor.h"
+
+// 平滑系数，约等于最近 16 帧的平均
+#define GOVERNOR_EMA_ALPHA 0.0625
+
+// 级别变化后至少观察的帧数
+#define GOVERNOR_HOLD_FRAMES 30
+
+// 解码耗时超过帧间隔的该比例即降级，低于 RESTORE 比例才升级
+#define GOVERNOR_DEGRADE_RATIO 0.9
+#define GOVERNOR_RESTORE_RATIO 0.5
+
+// 到达间隔超过该值视为断流（暂停、重连），不计入帧间隔
+#define GOVERNOR_MAX_INTERVAL_NS 500000000LL
+
+DecodeGovernor::DecodeGovernor(bool enabled)
+    : m_enabled(enabled)
+{
+}
+
+const char* DecodeGovernor::levelName(Level level)
+{
+    switch (level)
+    {
+    case LevelFull:
+        return "full";
+    case LevelSkipLoopFilter:
+        return "skipLoopFilter";
+    case LevelSkipNonRef:
+        return "skipNonRef";
+    case LevelFast:
+        return "fast";
+    case LevelFastScaler:
+        return "fastScaler";
+    default:
+        return "unknown";
+    }
+}
+
+void DecodeGovernor::reset()
+{
+    m_level = LevelFull;
+    m_lastArrivalNs = 0;
+    m_intervalNs = 0;
+    m_busyNs = 0;
+    m_framesSinceChange = 0;
+}
+
+bool DecodeGovernor::update(qint64 arrivalNs, qint64 busyNs)
+{
+    if (m_lastArrivalNs > 0) {
+        qint64 interval = arrivalNs - m_lastArrivalNs;
+        if (interval > 0 && interval < GOVERNOR_MAX_INTERVAL_NS) {
+            m_intervalNs = m_intervalNs > 0 ? m_intervalNs + (interval - m_intervalNs) * GOVERNOR_EMA_ALPHA
+                                            : interval;
+        }
+    }
+    m_lastArrivalNs = arrivalNs;
+    m_busyNs = m_busyNs > 0 ? m_busyNs + (busyNs - m_busyNs) * GOVERNOR_EMA_ALPHA : busyNs;
+
+    ++m_framesSinceChange;
+    if (!m_enabled || m_intervalNs <= 0 || m_framesSinceChange < GOVERNOR_HOLD_FRAMES) {
+        return false;
+    }
+
+    Level next = m_level;
+    if (m_busyNs > m_intervalNs * GOVERNOR_DEGRADE_RATIO && m_level + 1 < LevelCount) {
+        next = Level(m_level + 1);
+    } else if (m_busyNs < m_intervalNs * GOVERNOR_RESTORE_RATIO && m_level > LevelFull) {
+        next = Level(m_level - 1);
+    }
+    if (next == m_level) {
+        return false;
+    }
+
+    m_level = next;
+    m_framesSinceChange = 0;
+    ++m_changes;
+    return true;
+}
@@ -0,0 +1,49 @@
+#ifndef DECODEGOVERNOR_H
+#define DECODEGOVERNOR_H
+
+#include <QtGlobal>
+
+// 解码质量调节器
+// 比较每帧解码线程耗时（解码 + 色彩转换）与帧间隔，解码跟不上时逐级降低画质，
+// 余量恢复后再逐级还原。每次变动后至少观察 HOLD 帧，避免在两级之间来回振荡。
+class DecodeGovernor
+{
+public:
+    enum Level
+    {
+        LevelFull = 0,          // 完整解码
+        LevelSkipLoopFilter,    // 跳过环路滤波
+        LevelSkipNonRef,        // 再跳过非参考帧
+        LevelFast,              // 再启用 AV_CODEC_FLAG2_FAST（不严格符合标准的加速）
+        LevelFastScaler,        // 再把缩放算法降为 SWS_FAST_BILINEAR
+        LevelCount
+    };
+
+    explicit DecodeGovernor(bool enabled = true);
+
+    // 每解码一包调用一次，arrivalNs 为包到达时间，busyNs 为本包在解码线程的耗时
+    // 级别发生变化时返回 true
+    bool update(qint64 arrivalNs, qint64 busyNs);
+
+    void reset();
+
+    Level level() const { return m_level; }
+    static const char* levelName(Level level);
+
+    // 平滑后的帧间隔与解码耗时（纳秒）
+    qint64 frameIntervalNs() const { return qint64(m_intervalNs); }
+    qint64 busyNs() const { return qint64(m_busyNs); }
+    // 级别变化次数
+    int changeCount() const { return m_changes; }
+
+private:
+    bool m_enabled = true;
+    Level m_level = LevelFull;
+    qint64 m_lastArrivalNs = 0;
+    double m_intervalNs = 0;
+    double m_busyNs = 0;
+    int m_framesSinceChange = 0;
+    int m_changes = 0;
+};
+
+#endif // DECODEGOVERNOR_H
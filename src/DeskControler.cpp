@@ -21,6 +21,7 @@
 
 #include "VideoWidget.h"
 #include "LogWidget.h"
+#include "ThreadTuning.h"
 
 #define VIEW_SIZE QSize(1920, 1080)
 
@@ -33,6 +34,158 @@ const QString COLOR_TEXT_TITLE  = "#203764";  // 标题色
 const QString COLOR_TEXT_BTN    = "#FFFFFF";  // 按钮文字
 const QString COLOR_BORDER      = "#4472C4";  // 窗口边框
 
+// 视频输出像素格式在配置文件中的写法
+static const char* PIXEL_FORMAT_NAMES[] = { "auto", "rgb32", "rgb16" };
+
+// 访问单元分组方式在配置文件中的写法
+static const char* ACCESS_UNIT_MODE_NAMES[] = { "message", "frame", "slice" };
+
+// 编码格式在配置文件中的写法
+static const char* VIDEO_CODEC_NAMES[] = { "auto", "h264", "hevc", "mjpeg" };
+
+// 解码/转换线程拓扑在配置文件中的写法
+static const char* PIPELINE_TOPOLOGY_NAMES[] = { "auto", "fused", "split" };
+
+// 显示方式在配置文件中的写法
+static const char* RENDERER_NAMES[] = { "raster", "opengl", "multimedia" };
+
+// 线程调度策略，例如 { "nice": -4, "cores": "big" }
+static DeskThreadPolicy threadPolicyFromJson(const QJsonValue& value, const DeskThreadPolicy& defaults)
+{
+    DeskThreadPolicy policy = defaults;
+    QJsonObject policyObj = value.toObject();
+    policy.nice = qBound(-20, policyObj["nice"].toInt(policy.nice), 19);
+    QString cores = policyObj["cores"].toString(coreSetName(policy.cores)).toLower();
+    for (int i = 0; i < 3; ++i)
+    {
+        if (cores == coreSetName(static_cast<DeskCoreSet>(i)))
+        {
+            policy.cores = static_cast<DeskCoreSet>(i);
+        }
+    }
+    return policy;
+}
+
+static QJsonObject threadPolicyToJson(const DeskThreadPolicy& policy)
+{
+    QJsonObject policyObj;
+    policyObj["nice"] = policy.nice;
+    policyObj["cores"] = coreSetName(policy.cores);
+    return policyObj;
+}
+
+static DeskMemoryBudget memoryBudgetFromJson(const QJsonObject& budgetObj)
+{
+    DeskMemoryBudget budget;
+    budget.totalMB = budgetObj["totalMB"].toInt(budget.totalMB);
+    budget.receiveBufferMB = budgetObj["receiveBufferMB"].toInt(budget.receiveBufferMB);
+    budget.packetQueueMB = budgetObj["packetQueueMB"].toInt(budget.packetQueueMB);
+    budget.framePoolMB = budgetObj["framePoolMB"].toInt(budget.framePoolMB);
+    budget.sendQueueKB = budgetObj["sendQueueKB"].toInt(budget.sendQueueKB);
+    return budget;
+}
+
+static QJsonObject memoryBudgetToJson(const DeskMemoryBudget& budget)
+{
+    QJsonObject budgetObj;
+    budgetObj["totalMB"] = budget.totalMB;
+    budgetObj["receiveBufferMB"] = budget.receiveBufferMB;
+    budgetObj["packetQueueMB"] = budget.packetQueueMB;
+    budgetObj["framePoolMB"] = budget.framePoolMB;
+    budgetObj["sendQueueKB"] = budget.sendQueueKB;
+    return budgetObj;
+}
+
+static DeskVideoConfig videoConfigFromJson(const QJsonObject& videoObj)
+{
+    DeskVideoConfig config;
+    QString pixelFormat = videoObj["pixelFormat"].toString("auto").toLower();
+    for (int i = 0; i < 3; ++i)
+    {
+        if (pixelFormat == PIXEL_FORMAT_NAMES[i])
+        {
+            config.pixelFormat = static_cast<DeskPixelFormat>(i);
+        }
+    }
+    config.convertThreads = videoObj["convertThreads"].toInt(0);
+    config.latencyBudgetMs = videoObj["latencyBudgetMs"].toInt(config.latencyBudgetMs);
+    config.maxQueuedPackets = videoObj["maxQueuedPackets"].toInt(config.maxQueuedPackets);
+    config.decodeThreads = videoObj["decodeThreads"].toInt(config.decodeThreads);
+    config.mjpegDecodeThreads = videoObj["mjpegDecodeThreads"].toInt(config.mjpegDecodeThreads);
+    config.adaptiveQuality = videoObj["adaptiveQuality"].toBool(config.adaptiveQuality);
+    QString accessUnitMode = videoObj["accessUnitMode"].toString("frame").toLower();
+    for (int i = 0; i < 3; ++i)
+    {
+        if (accessUnitMode == ACCESS_UNIT_MODE_NAMES[i])
+        {
+            config.accessUnitMode = static_cast<DeskAccessUnitMode>(i);
+        }
+    }
+    QString codec = videoObj["codec"].toString("auto").toLower();
+    for (int i = 0; i < 4; ++i)
+    {
+        if (codec == VIDEO_CODEC_NAMES[i])
+        {
+            config.codec = static_cast<DeskVideoCodec>(i);
+        }
+    }
+    QString pipeline = videoObj["pipeline"].toString("auto").toLower();
+    for (int i = 0; i < 3; ++i)
+    {
+        if (pipeline == PIPELINE_TOPOLOGY_NAMES[i])
+        {
+            config.pipeline = static_cast<DeskPipelineTopology>(i);
+        }
+    }
+    QJsonObject threadsObj = videoObj["threads"].toObject();
+    config.networkThread = threadPolicyFromJson(threadsObj["network"], config.networkThread);
+    config.decodeThread = threadPolicyFromJson(threadsObj["decode"], config.decodeThread);
+    config.convertThread = threadPolicyFromJson(threadsObj["convert"], config.convertThread);
+    config.memoryBudget = memoryBudgetFromJson(videoObj["memoryBudget"].toObject());
+    config.suspendInBackground = videoObj["suspendInBackground"].toBool(true);
+    config.changeDetection = videoObj["changeDetection"].toBool(false);
+    config.maxZoom = qMax(1.0, videoObj["maxZoom"].toDouble(4.0));
+    config.smoothScaling = videoObj["smoothScaling"].toBool(true);
+    QString renderer = videoObj["renderer"].toString("raster").toLower();
+    for (int i = 0; i < 3; ++i)
+    {
+        if (renderer == RENDERER_NAMES[i])
+        {
+            config.renderer = static_cast<DeskRenderer>(i);
+        }
+    }
+    config.recordStreamPath = videoObj["recordStreamPath"].toString();
+    return config;
+}
+
+static QJsonObject videoConfigToJson(const DeskVideoConfig& config)
+{
+    QJsonObject videoObj;
+    videoObj["pixelFormat"] = PIXEL_FORMAT_NAMES[config.pixelFormat];
+    videoObj["convertThreads"] = config.convertThreads;
+    videoObj["latencyBudgetMs"] = config.latencyBudgetMs;
+    videoObj["maxQueuedPackets"] = config.maxQueuedPackets;
+    videoObj["decodeThreads"] = config.decodeThreads;
+    videoObj["mjpegDecodeThreads"] = config.mjpegDecodeThreads;
+    videoObj["adaptiveQuality"] = config.adaptiveQuality;
+    videoObj["accessUnitMode"] = ACCESS_UNIT_MODE_NAMES[config.accessUnitMode];
+    videoObj["codec"] = VIDEO_CODEC_NAMES[config.codec];
+    videoObj["pipeline"] = PIPELINE_TOPOLOGY_NAMES[config.pipeline];
+    QJsonObject threadsObj;
+    threadsObj["network"] = threadPolicyToJson(config.networkThread);
+    threadsObj["decode"] = threadPolicyToJson(config.decodeThread);
+    threadsObj["convert"] = threadPolicyToJson(config.convertThread);
+    videoObj["threads"] = threadsObj;
+    videoObj["memoryBudget"] = memoryBudgetToJson(config.memoryBudget);
+    videoObj["suspendInBackground"] = config.suspendInBackground;
+    videoObj["changeDetection"] = config.changeDetection;
+    videoObj["maxZoom"] = config.maxZoom;
+    videoObj["smoothScaling"] = config.smoothScaling;
+    videoObj["renderer"] = RENDERER_NAMES[config.renderer];
+    videoObj["recordStreamPath"] = config.recordStreamPath;
+    return videoObj;
+}
+
 // 字体大小配置
 const QString FONT_TITLE_EN     = "24px";     // 英文标题大小
 const QString FONT_TITLE_CN     = "48px";     // 中文标题大小 (加粗)
@@ -434,6 +587,7 @@ void DeskControler::loadConfig()
             {"port", 21116}
         };
         config["uuid"] = "";
+        config["video"] = videoConfigToJson(DeskVideoConfig());
 
         if (file.open(QIODevice::WriteOnly)) {
             QJsonDocument doc(config);
@@ -447,6 +601,7 @@ void DeskControler::loadConfig()
     QString ip = serverObj["ip"].toString("127.0.0.1");
     int port = serverObj["port"].toInt(21116);
     QString uuid = config["uuid"].toString("");
+    m_videoConfig = videoConfigFromJson(config["video"].toObject());
 
     // // 设置 UI 控件
     // ui.ipLineEdit_->setText(ip);
@@ -466,6 +621,7 @@ void DeskControler::saveConfig()
     serverObj["port"] = m_serverPort; // ui.portLineEdit_->text().toInt();
     config["server"] = serverObj;
     config["uuid"] = m_uuid; // ui.lineEdit->text().trimmed();
+    config["video"] = videoConfigToJson(m_videoConfig);
 
     QJsonDocument doc(config);
     QFile file(m_dir + "/DeskControler.json");
@@ -949,8 +1105,12 @@ void DeskControler::setupVideoSession(const QString& relayServer, quint16 relayP
 
     // 连接逻辑
     m_scrollArea = nullptr;
-    m_videoReceiver = new VideoReceiver(this);
-    connect(m_videoReceiver, &VideoReceiver::networkError, this, &DeskControler::onVideoReceiverError);
+    // 接收流水线（网络、解码线程）在第一次连接时创建，之后各会话复用
+    if (!m_videoReceiver) {
+        m_videoReceiver = new VideoReceiver(m_videoConfig, this);
+        connect(m_videoReceiver, &VideoReceiver::networkError, this, &DeskControler::onVideoReceiverError);
+        connect(m_videoReceiver, &VideoReceiver::sessionStopped, this, &DeskControler::onVideoSessionStopped);
+    }
 
     connect(videoWidget, &VideoWidget::mouseEventCaptured, m_videoReceiver, &VideoReceiver::mouseEventCaptured);
     connect(videoWidget, &VideoWidget::touchEventCaptured, m_videoReceiver, &VideoReceiver::touchEventCaptured);
@@ -959,10 +1119,17 @@ void DeskControler::setupVideoSession(const QString& relayServer, quint16 relayP
     static bool firstFrame = true;
     firstFrame = true;
 
-    connect(m_videoReceiver, &VideoReceiver::frameReady, this, [videoWidget](const QImage& img) {
-        videoWidget->setFrame(img);
-        videoWidget->update();
-    });
+    connect(videoWidget, &VideoWidget::targetSizeChanged, m_videoReceiver, &VideoReceiver::setTargetSize);
+    m_videoReceiver->setTargetSize(videoWidget->size());
+    videoWidget->setMaxZoom(m_videoConfig.maxZoom);
+    connect(videoWidget, &VideoWidget::visibleRectChanged, m_videoReceiver, &VideoReceiver::setVisibleRect);
+    m_videoReceiver->setVisibleRect(videoWidget->visibleRect());
+
+    videoWidget->setFrameMailbox(m_videoReceiver->frameMailbox());
+    videoWidget->setSmoothScaling(m_videoConfig.smoothScaling);
+    connect(videoWidget, &VideoWidget::yuvOutputChanged, m_videoReceiver, &VideoReceiver::setYuvOutput);
+    videoWidget->setRenderer(m_videoConfig.renderer);
+    connect(m_videoReceiver, &VideoReceiver::frameAvailable, videoWidget, &VideoWidget::onFrameAvailable);
 
     //QString uuid = ui.lineEdit->text();
     QString uuid = m_uuid;  // 使用成员变量
@@ -983,31 +1150,25 @@ void DeskControler::destroyVideoSession()
 
     if (oldNetManager) {
         oldNetManager->disconnect(); // 断开所有信号
-        QTimer::singleShot(100, oldNetManager, [oldNetManager](){
-            oldNetManager->cleanup();
-            oldNetManager->deleteLater();
-        });
+        // deleteLater 会等当前信号处理返回后才析构，不需要再延时
+        oldNetManager->cleanup();
+        oldNetManager->deleteLater();
     }
 
-    // VideoReceiver
-    VideoReceiver* oldReceiver = m_videoReceiver;
-    m_videoReceiver = nullptr; // 立即置空
-
-    if (oldReceiver) {
-        oldReceiver->disconnect(); // 立即断开 frameReady 等信号，防止刷新 UI
-
-        QTimer::singleShot(50, oldReceiver, [oldReceiver](){
-            oldReceiver->stopReceiving();
-            oldReceiver->deleteLater();
-        });
+    // VideoReceiver: 线程保留，只异步关闭 socket 和解码器，完成后在 onVideoSessionStopped 恢复“连接”按钮
+    // 点击断开 -> 界面切回 -> 按钮变灰 -> 会话清理完毕后按钮变回“连接”
+    if (m_videoReceiver && m_videoReceiver->isSessionActive()) {
+        // 立即断开到旧 VideoWidget 的帧通知，防止刷新 UI
+        disconnect(m_videoReceiver, &VideoReceiver::frameAvailable, nullptr, nullptr);
+        ui.pushButton->setEnabled(false);
+        m_videoReceiver->stopSession();
     }
+}
 
-    // 延时 500ms 后再恢复“连接”按钮
-    // 点击断开 -> 界面切回 -> 按钮变灰半秒 -> 按钮变回“连接”
-    QTimer::singleShot(500, this, [this](){
-        ui.pushButton->setText("连接");
-        ui.pushButton->setEnabled(true);
-    });
+void DeskControler::onVideoSessionStopped()
+{
+    ui.pushButton->setText("连接");
+    ui.pushButton->setEnabled(true);
 }
 
 void DeskControler::destroyVideoWidget()
@@ -1079,6 +1240,17 @@ void DeskControler::onVideoReceiverError(const QString &error)
 void DeskControler::onApplicationStateChanged(Qt::ApplicationState state)
 {
     LogWidget::instance()->addLog(QString("onApplicationStateChanged %1").arg(state), LogWidget::Warning);
+
+    // 后台或熄屏时画面不可见，暂停解码和转换；Android 的 Inactive 对应 Activity onPause，
+    // 桌面平台的 Inactive 只是失去焦点，窗口仍可见
+    if (m_videoReceiver && m_videoConfig.suspendInBackground)
+    {
+        bool hidden = state == Qt::ApplicationSuspended || state == Qt::ApplicationHidden;
+#ifdef Q_OS_ANDROID
+        hidden |= state == Qt::ApplicationInactive;
+#endif
+        m_videoReceiver->setSuspended(hidden);
+    }
     if (state == Qt::ApplicationActive && m_scrollArea)
     {
 #ifdef Q_OS_ANDROID
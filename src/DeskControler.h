@@ -14,6 +14,7 @@
 
 #include "NetworkManager.h"
 #include "VideoReceiver.h"
+#include "DeskDefine.h"
 #include "ui_DeskControler.h"
 // #include "RemoteClipboard.h"
 
@@ -156,6 +157,8 @@ private slots:
     void onNetworkError(const QString& error);
     void onNetworkDisconnected();
     void onVideoReceiverError(const QString& error);
+    // 接收流水线已清理完上一个会话
+    void onVideoSessionStopped();
     void onApplicationStateChanged(Qt::ApplicationState state);
 
     void showMainPage(); // 显示主控页
@@ -209,6 +212,9 @@ private:
     quint16 m_serverPort = 0;
     QString m_uuid;
 
+    // 视频会话配置
+    DeskVideoConfig m_videoConfig;
+
     // ============ Kiosk模式相关成员变量 ============
     bool m_kioskModeEnabled = false;        // Kiosk模式是否启用
     int m_debugExitTapCount = 0;            // 调试退出点击计数
@@ -27,7 +27,29 @@ HEADERS += \
     VideoReceiver.h \
     VideoWidget.h \
     VideoDecoderWorker.h \
-    NetworkWorker.h
+    YuvConverter.h \
+    NetworkWorker.h \
+    AccessUnitAssembler.h \
+    BlockHasher.h \
+    DecodeGovernor.h \
+    FrameMailbox.h \
+    FramePool.h \
+    GLVideoRenderer.h \
+    GLYuvProgram.h \
+    H264Nal.h \
+    MemoryBudget.h \
+    MjpegDecodePool.h \
+    MultimediaVideoOutput.h \
+    NalIndex.h \
+    PacketPool.h \
+    PacketQueue.h \
+    SliceThreadPool.h \
+    SpscQueue.h \
+    StageMeter.h \
+    StreamParser.h \
+    StreamRecorder.h \
+    StreamStats.h \
+    ThreadTuning.h
 
 SOURCES += \
     AndroidVideoSurface.cpp \
@@ -35,10 +57,30 @@ SOURCES += \
     NetworkManager.cpp \
     NetworkWorker.cpp \
     VideoDecoderWorker.cpp \
+    YuvConverter.cpp \
     VideoReceiver.cpp \
     VideoWidget.cpp \
     DeskControler.cpp \
     LogWidget.cpp \
+    AccessUnitAssembler.cpp \
+    BlockHasher.cpp \
+    DecodeGovernor.cpp \
+    FrameMailbox.cpp \
+    FramePool.cpp \
+    GLVideoRenderer.cpp \
+    GLYuvProgram.cpp \
+    H264Nal.cpp \
+    MemoryBudget.cpp \
+    MjpegDecodePool.cpp \
+    MultimediaVideoOutput.cpp \
+    PacketPool.cpp \
+    PacketQueue.cpp \
+    SliceThreadPool.cpp \
+    StageMeter.cpp \
+    StreamParser.cpp \
+    StreamRecorder.cpp \
+    StreamStats.cpp \
+    ThreadTuning.cpp \
     main.cpp
 
 # LIBS += -luser32
@@ -5,6 +5,8 @@
 
 #include <QObject>
 #include <QList>
+#include <QRect>
+#include <QStringList>
 
 enum MouseMask
 {
@@ -58,4 +60,160 @@ struct DeskTouchEvent
 };
 Q_DECLARE_METATYPE(DeskTouchEvent)
 
+// 远端画面在控件中的显示区域: 保持比例缩放，水平居中，垂直下对齐
+// VideoWidget 绘制和解码线程的缩放目标共用这一计算
+inline QRect deskLetterboxRect(const QSize &widgetSize, const QSize &imageSize)
+{
+    if (widgetSize.isEmpty() || imageSize.isEmpty())
+    {
+        return QRect();
+    }
+
+    qreal scaleW = (qreal)widgetSize.width() / imageSize.width();
+    qreal scaleH = (qreal)widgetSize.height() / imageSize.height();
+    qreal scale = qMin(scaleW, scaleH);
+
+    int drawW = static_cast<int>(imageSize.width() * scale);
+    int drawH = static_cast<int>(imageSize.height() * scale);
+
+    // 水平居中
+    int offsetX = (widgetSize.width() - drawW) / 2;
+    // 垂直下对齐
+    // 如果要垂直居中，则是 (widgetSize.height() - drawH) / 2
+    int offsetY = widgetSize.height() - drawH;
+
+    return QRect(offsetX, offsetY, drawW, drawH);
+}
+
+// 放大时可见的源画面区域: visible 为相对源画面的归一化矩形（空表示整个画面），返回源像素坐标
+// 起点和尺寸对齐到偶数，4:2:0 的色度平面按同一区域裁剪；VideoWidget 和解码线程用它得到同一块区域
+inline QRect deskVisibleSourceRect(const QRectF &visible, const QSize &imageSize)
+{
+    QRect full(QPoint(0, 0), imageSize);
+    if (visible.isEmpty() || imageSize.isEmpty())
+    {
+        return full;
+    }
+
+    int width = qBound(qMin(2, imageSize.width()), (qRound(visible.width() * imageSize.width()) + 1) & ~1, imageSize.width());
+    int height = qBound(qMin(2, imageSize.height()), (qRound(visible.height() * imageSize.height()) + 1) & ~1, imageSize.height());
+    int x = qBound(0, qRound(visible.x() * imageSize.width()) & ~1, (imageSize.width() - width) & ~1);
+    int y = qBound(0, qRound(visible.y() * imageSize.height()) & ~1, (imageSize.height() - height) & ~1);
+    return QRect(x, y, width, height);
+}
+
+// 源像素矩形换算回归一化坐标
+inline QRectF deskNormalizedRect(const QRect &rect, const QSize &imageSize)
+{
+    return QRectF(qreal(rect.x()) / imageSize.width(), qreal(rect.y()) / imageSize.height(),
+                  qreal(rect.width()) / imageSize.width(), qreal(rect.height()) / imageSize.height());
+}
+
+// 解码输出像素格式
+enum DeskPixelFormat
+{
+    PIXEL_FORMAT_AUTO  = 0, // 跟随绘制引擎的首选格式
+    PIXEL_FORMAT_RGB32 = 1, // QImage::Format_RGB32，光栅引擎免转换
+    PIXEL_FORMAT_RGB16 = 2  // QImage::Format_RGB16，低端平板上内存带宽减半
+};
+
+// 视频编码格式，AUTO 时根据码流开头识别（协议中没有编码格式字段）
+enum DeskVideoCodec
+{
+    VIDEO_CODEC_AUTO  = 0,
+    VIDEO_CODEC_H264  = 1,
+    VIDEO_CODEC_HEVC  = 2,
+    VIDEO_CODEC_MJPEG = 3
+};
+
+// 码流送入解码器的分组方式，见 AccessUnitAssembler
+enum DeskAccessUnitMode
+{
+    AU_MODE_MESSAGE = 0, // 每条网络消息末尾即一帧结束，只拆分多帧消息；NAL 被拆到两条消息时会截断
+    AU_MODE_FRAME   = 1, // 等到下一帧开始再输出，容忍一帧拆成多条消息
+    AU_MODE_SLICE   = 2  // 逐片送入解码器，适合每片一条消息的低延迟编码器
+};
+
+// 解码与色彩转换的线程拓扑
+// 接收和组帧始终在网络线程，显示始终在 GUI 线程
+enum DeskPipelineTopology
+{
+    PIPELINE_AUTO  = 0, // 4 核及以上拆分，否则合并
+    PIPELINE_FUSED = 1, // 解码线程上依次解码、转换，适合低端设备
+    PIPELINE_SPLIT = 2  // 转换在独立线程上，与下一帧的解码并行
+};
+
+// 视频画面的显示方式
+enum DeskRenderer
+{
+    RENDERER_RASTER     = 0, // 解码线程转换为 RGB，QPainter 贴图
+    RENDERER_OPENGL     = 1, // 直接上传 YUV 平面，在片元着色器里做色彩转换和缩放；不可用时回退到 RASTER
+    RENDERER_MULTIMEDIA = 2  // YUV 帧包装成 QVideoFrame 交给 QVideoWidget；surface 不支持时回退到 RASTER
+};
+
+// 线程亲和的核心集合，大小核按 sysfs 中各核心的算力划分
+enum DeskCoreSet
+{
+    CORES_ANY    = 0, // 不限制
+    CORES_BIG    = 1, // 只在大核上运行
+    CORES_LITTLE = 2  // 只在小核上运行
+};
+
+// 流水线线程的调度策略
+struct DeskThreadPolicy
+{
+    // setpriority 的 nice 值，越小优先级越高；Android 的 THREAD_PRIORITY_DISPLAY 为 -4
+    int nice = 0;
+    DeskCoreSet cores = CORES_ANY;
+};
+
+// 视频会话各子系统的内存额度，见 MemoryBudget
+struct DeskMemoryBudget
+{
+    int totalMB = 192;          // 会话总额度
+    int receiveBufferMB = 8;    // socket 读缓冲 + 分帧缓冲，包队列积压时暂停读取，数据留在这里和内核
+    int packetQueueMB = 32;     // 待解码的码流包，超出时按 GOP 丢包
+    int framePoolMB = 128;      // 解码输出的 RGB 帧（含 MJPEG 线程池），超出时丢帧
+    int sendQueueKB = 256;      // 待发送的输入事件，超出时丢弃移动事件
+};
+
+// 视频会话配置，来自 DeskControler.json 的 "video" 节点
+struct DeskVideoConfig
+{
+    DeskPixelFormat pixelFormat = PIXEL_FORMAT_AUTO;
+    // 色彩转换并行线程数（含解码线程），0 表示按核心数自动选择
+    int convertThreads = 0;
+    // 包队列最长排队时间，超出时跳到最新 IDR 或丢弃非参考帧
+    int latencyBudgetMs = 200;
+    // 包队列容量，超出后清空并等待下一个关键帧
+    int maxQueuedPackets = 30;
+    // 解码器切片线程数，0 表示按核心数自动选择
+    int decodeThreads = 0;
+    // 解码跟不上帧率时自动降低解码质量
+    bool adaptiveQuality = true;
+    // 默认按帧组装: 服务端可能把一个 NAL 拆到两条消息里，消息模式会把截断的 NAL 送进解码器
+    DeskAccessUnitMode accessUnitMode = AU_MODE_FRAME;
+    DeskVideoCodec codec = VIDEO_CODEC_AUTO;
+    DeskPipelineTopology pipeline = PIPELINE_AUTO;
+    // MJPEG 帧并行解码线程数，0 表示按核心数自动选择，1 表示在解码线程上串行解码
+    int mjpegDecodeThreads = 0;
+    // 各阶段线程的调度策略: 网络线程不限核心，解码和转换放到大核（转换策略同样用于切片线程）
+    DeskThreadPolicy networkThread = { -4, CORES_ANY };
+    DeskThreadPolicy decodeThread = { -4, CORES_BIG };
+    DeskThreadPolicy convertThread = { -4, CORES_BIG };
+    DeskMemoryBudget memoryBudget;
+    // 程序退到后台或熄屏时暂停解码和转换，回到前台后从下一个关键帧恢复
+    bool suspendInBackground = true;
+    // 双指缩放的最大倍数，1 表示关闭本地缩放（双指手势照常发给远端）
+    double maxZoom = 4.0;
+    // 逐块比较相邻帧，画面不变时整帧跳过，变化很少时只转换和重绘变化的块
+    // 每帧多约 1ms 哈希（1080p），只在相同帧多的画面上划算，默认关闭
+    bool changeDetection = false;
+    // 显示尺寸与解码输出不一致时 VideoWidget 临时缩放用平滑插值（关闭则用最近邻，更快）
+    bool smoothScaling = true;
+    DeskRenderer renderer = RENDERER_RASTER;
+    // 以长度前缀格式录制收到的原始码流，供解码基准测试使用（空表示不录制）
+    QString recordStreamPath;
+};
+
 #endif // DESKDEFINE_H
@@ -0,0 +1,46 @@
+#include "FrameMailbox.h"
+
+FrameMailbox::FrameMailbox()
+{
+}
+
+bool FrameMailbox::publish(const VideoFrame& frame)
+{
+    m_slots[m_back] = frame;
+
+    // 中间槽的帧 UI 还没取走，交换后就被丢弃；这里与 take() 有竞争，判断为未取走而实际已取走时只是多重绘一些
+    VideoFrame& slot = m_slots[m_back];
+    if (m_middle.load(std::memory_order_acquire) & SLOT_DIRTY)
+    {
+        slot.dirty = (slot.dirty.isEmpty() || m_lastDirty.isEmpty()) ? QRegion() : slot.dirty + m_lastDirty;
+    }
+    m_lastDirty = slot.dirty;
+
+    int previous = m_middle.exchange(m_back | SLOT_DIRTY, std::memory_order_acq_rel);
+    m_back = previous & SLOT_MASK;
+
+    // 换回来的槽要么是 UI 已经显示过的旧帧，要么是从未显示就被覆盖的帧，
+    // 都立即释放，让对应的缓冲区尽快回到 FramePool
+    m_slots[m_back] = VideoFrame();
+
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    if (previous & SLOT_DIRTY)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    return true;
+}
+
+bool FrameMailbox::take(VideoFrame& frame)
+{
+    if (!(m_middle.load(std::memory_order_acquire) & SLOT_DIRTY))
+    {
+        return false;
+    }
+
+    int previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+    m_front = previous & SLOT_MASK;
+    frame = m_slots[m_front];
+    return true;
+}
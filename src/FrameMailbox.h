@@ -0,0 +1,62 @@
+#ifndef FRAMEMAILBOX_H
+#define FRAMEMAILBOX_H
+
+#include <QImage>
+#include <QRectF>
+#include <QRegion>
+#include <QSize>
+#include <atomic>
+#include <memory>
+
+struct AVFrame;
+
+// 解码完成、等待显示的一帧
+struct VideoFrame
+{
+    QImage image;          // 已转换（并缩放）好的画面
+    std::shared_ptr<AVFrame> yuv; // OpenGL 渲染时为解码输出的引用（未转换的 YUV 平面），此时 image 为空
+    QSize sourceSize;      // 远端画面原始分辨率
+    QRegion dirty;         // 相对 UI 取到的上一帧有变化的区域（image 坐标），为空表示整帧
+    QRectF visibleRect = QRectF(0, 0, 1, 1); // image 对应的源画面区域（归一化），放大时只转换这一块
+    qint64 receivedNs = 0; // 对应数据包进入解码线程的时间
+    qint64 decodedNs = 0;  // 转换完成、发布的时间
+};
+
+// 解码线程与 UI 线程之间的最新帧邮箱（三缓冲）
+// 解码线程 publish() 只覆盖中间槽，UI 线程收到通知后 take() 最新一帧。
+// GUI 线程卡顿时旧帧被直接覆盖并计为丢弃，不会像排队信号那样无限堆积。
+// 仅支持单生产者、单消费者。
+class FrameMailbox
+{
+public:
+    FrameMailbox();
+
+    // 解码线程调用。返回 true 表示 UI 已取走上一帧，需要重新通知刷新；
+    // 返回 false 表示上一次通知尚未被处理，无需重复投递
+    // 上一帧还没被取走时会被本帧覆盖，本帧的 dirty 会并上上一帧的，UI 按它重绘不会漏掉区域
+    bool publish(const VideoFrame& frame);
+
+    // UI 线程调用。有新帧时写入 frame 并返回 true
+    bool take(VideoFrame& frame);
+
+    quint64 publishedCount() const { return m_published.load(std::memory_order_relaxed); }
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    FrameMailbox(const FrameMailbox&) = delete;
+    FrameMailbox& operator=(const FrameMailbox&) = delete;
+
+private:
+    static const int SLOT_MASK = 0x3;
+    static const int SLOT_DIRTY = 0x4; // 中间槽有尚未被取走的新帧
+
+    VideoFrame m_slots[3];
+    int m_back = 0;                 // 仅解码线程访问
+    QRegion m_lastDirty;            // 上一次发布的变化区域，仅解码线程访问
+    int m_front = 1;                // 仅 UI 线程访问
+    std::atomic<int> m_middle{2};   // 槽号 | SLOT_DIRTY
+
+    std::atomic<quint64> m_published{0};
+    std::atomic<quint64> m_dropped{0};
+};
+
+#endif // FRAMEMAILBOX_H
@@ -0,0 +1,198 @@
+#include "FramePool.h"
+
+extern "C" {
+#include <libavutil/mem.h>
+}
+
+struct FramePool::Buffer
+{
+    State* owner = nullptr;
+    uchar* data = nullptr;
+    int bytes = 0;
+};
+
+// 池状态由池本身和每个在途缓冲区共同持有引用，
+// 池先于 QImage 析构时，在途缓冲区归还时再释放
+struct FramePool::State
+{
+    QMutex mutex;
+    QVector<Buffer*> freeList;
+    int capacity = 0;
+    int bufferBytes = 0;
+    bool closed = false;
+    quint64 hits = 0;
+    quint64 misses = 0;
+    std::atomic<qint64> allocatedBytes{0};
+    std::atomic<int> refs{1};
+};
+
+static void freeBuffer(void* buffer)
+{
+    av_free(buffer);
+}
+
+FramePool::FramePool(int capacity)
+    : m_state(new State)
+{
+    m_state->capacity = capacity;
+    m_state->freeList.reserve(capacity);
+}
+
+FramePool::~FramePool()
+{
+    {
+        QMutexLocker locker(&m_state->mutex);
+        m_state->closed = true;
+        for (Buffer* buf : m_state->freeList)
+        {
+            m_state->allocatedBytes -= buf->bytes;
+            freeBuffer(buf->data);
+            delete buf;
+        }
+        m_state->freeList.clear();
+    }
+    releaseState(m_state);
+    m_state = nullptr;
+}
+
+void FramePool::releaseState(State* state)
+{
+    if (state->refs.fetch_sub(1) == 1)
+    {
+        delete state;
+    }
+}
+
+void FramePool::setCapacity(int capacity)
+{
+    QMutexLocker locker(&m_state->mutex);
+    m_state->capacity = capacity;
+    while (m_state->freeList.size() > capacity)
+    {
+        Buffer* buf = m_state->freeList.takeLast();
+        m_state->allocatedBytes -= buf->bytes;
+        freeBuffer(buf->data);
+        delete buf;
+    }
+}
+
+int FramePool::capacity() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->capacity;
+}
+
+quint64 FramePool::hits() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->hits;
+}
+
+quint64 FramePool::misses() const
+{
+    QMutexLocker locker(&m_state->mutex);
+    return m_state->misses;
+}
+
+qint64 FramePool::allocatedBytes() const
+{
+    return m_state->allocatedBytes.load(std::memory_order_relaxed);
+}
+
+int FramePool::bytesPerLineFor(int width, QImage::Format format)
+{
+    // 行对齐到 32 字节，满足 QImage 的 4 字节要求并方便 SIMD 写入
+    int depth = QImage::toPixelFormat(format).bitsPerPixel();
+    return ((width * depth / 8) + 31) & ~31;
+}
+
+qint64 FramePool::acquireCost(int width, int height, QImage::Format format) const
+{
+    if (width <= 0 || height <= 0)
+    {
+        return 0;
+    }
+    int bytes = bytesPerLineFor(width, format) * height;
+    QMutexLocker locker(&m_state->mutex);
+    return (bytes == m_state->bufferBytes && !m_state->freeList.isEmpty()) ? 0 : bytes;
+}
+
+QImage FramePool::acquire(int width, int height, QImage::Format format)
+{
+    if (width <= 0 || height <= 0)
+    {
+        return QImage();
+    }
+
+    int bytesPerLine = bytesPerLineFor(width, format);
+    int bytes = bytesPerLine * height;
+
+    Buffer* buf = nullptr;
+    {
+        QMutexLocker locker(&m_state->mutex);
+        if (bytes != m_state->bufferBytes)
+        {
+            // 分辨率或格式变化，旧尺寸的空闲缓冲区全部作废
+            for (Buffer* old : m_state->freeList)
+            {
+                m_state->allocatedBytes -= old->bytes;
+                freeBuffer(old->data);
+                delete old;
+            }
+            m_state->freeList.clear();
+            m_state->bufferBytes = bytes;
+        }
+
+        if (!m_state->freeList.isEmpty())
+        {
+            buf = m_state->freeList.takeLast();
+            ++m_state->hits;
+        }
+        else
+        {
+            ++m_state->misses;
+        }
+    }
+
+    if (!buf)
+    {
+        uchar* data = static_cast<uchar*>(av_malloc(bytes));
+        if (!data)
+        {
+            return QImage();
+        }
+        buf = new Buffer;
+        buf->owner = m_state;
+        buf->data = data;
+        buf->bytes = bytes;
+        m_state->allocatedBytes += bytes;
+    }
+
+    m_state->refs.fetch_add(1);
+    return QImage(buf->data, width, height, bytesPerLine, format, &FramePool::releaseBuffer, buf);
+}
+
+void FramePool::releaseBuffer(void* info)
+{
+    Buffer* buf = static_cast<Buffer*>(info);
+    State* state = buf->owner;
+
+    bool recycled = false;
+    {
+        QMutexLocker locker(&state->mutex);
+        if (!state->closed && buf->bytes == state->bufferBytes
+            && state->freeList.size() < state->capacity)
+        {
+            state->freeList.append(buf);
+            recycled = true;
+        }
+    }
+
+    if (!recycled)
+    {
+        state->allocatedBytes -= buf->bytes;
+        freeBuffer(buf->data);
+        delete buf;
+    }
+    releaseState(state);
+}
@@ -0,0 +1,46 @@
+#ifndef FRAMEPOOL_H
+#define FRAMEPOOL_H
+
+#include <QImage>
+#include <QMutex>
+#include <QVector>
+#include <atomic>
+
+// 解码输出帧（RGB）缓冲池
+// acquire() 返回直接引用池内缓冲区的 QImage，最后一个 QImage 拷贝析构时通过 cleanupFunction
+// 把缓冲区还给池。容量按解码器到 VideoWidget 之间同时在途的帧数设定，稳态下不再分配内存。
+class FramePool
+{
+public:
+    explicit FramePool(int capacity);
+    ~FramePool();
+
+    // 取一块缓冲区包装成 QImage，内容未初始化，由调用方整帧写满
+    QImage acquire(int width, int height, QImage::Format format);
+
+    void setCapacity(int capacity);
+    int capacity() const;
+
+    // 命中: 复用池内空闲缓冲区; 未命中: 池空或尺寸变化时新分配
+    quint64 hits() const;
+    quint64 misses() const;
+    // 当前分配的缓冲区总字节数（空闲 + 在途）
+    qint64 allocatedBytes() const;
+    // 按该尺寸 acquire 需要新分配的字节数，有可复用的空闲缓冲区时为 0
+    qint64 acquireCost(int width, int height, QImage::Format format) const;
+
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+private:
+    struct Buffer;
+    struct State;
+
+    static void releaseBuffer(void* info);
+    static void releaseState(State* state);
+    static int bytesPerLineFor(int width, QImage::Format format);
+
+    State* m_state = nullptr;
+};
+
+#endif // FRAMEPOOL_H
@@ -0,0 +1,115 @@
+#include "GLVideoRenderer.h"
+#include "LogWidget.h"
+#include "StreamStats.h"
+
+#include <QElapsedTimer>
+#include <QOpenGLContext>
+#include <QSurfaceFormat>
+
+// 每累计多少帧汇总一次上传和绘制耗时
+#define GL_STATS_INTERVAL 120
+
+GLVideoRenderer::GLVideoRenderer(QWidget* parent)
+    : QOpenGLWidget(parent)
+{
+}
+
+GLVideoRenderer::~GLVideoRenderer()
+{
+    if (!m_ready)
+    {
+        return;
+    }
+    makeCurrent();
+    m_yuv.destroy();
+    doneCurrent();
+}
+
+bool GLVideoRenderer::isAvailable()
+{
+    QOpenGLContext context;
+    context.setFormat(QSurfaceFormat::defaultFormat());
+    return context.create();
+}
+
+void GLVideoRenderer::setFrame(const VideoFrame& frame)
+{
+    m_pending = frame.yuv;
+    update();
+}
+
+void GLVideoRenderer::setSmoothScaling(bool smooth)
+{
+    m_smooth = smooth;
+    update();
+}
+
+void GLVideoRenderer::setVisibleRect(const QRectF& rect)
+{
+    m_visibleRect = rect;
+    update();
+}
+
+void GLVideoRenderer::initializeGL()
+{
+    initializeOpenGLFunctions();
+
+    LogWidget::instance()->addLog(QString("[GLVideoRenderer] %1, %2")
+                                      .arg(reinterpret_cast<const char*>(glGetString(GL_RENDERER)))
+                                      .arg(reinterpret_cast<const char*>(glGetString(GL_VERSION))),
+                                  LogWidget::Info);
+
+    if (!m_yuv.initialize())
+    {
+        QString reason = m_yuv.log();
+        LogWidget::instance()->addLog("[GLVideoRenderer] shader build failed: " + reason, LogWidget::Error);
+        emit initFailed(reason);
+        return;
+    }
+    m_ready = true;
+}
+
+void GLVideoRenderer::paintGL()
+{
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (!m_ready)
+    {
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    if (m_pending)
+    {
+        // 上传完立即释放帧引用，解码器的缓冲区尽快回池
+        std::shared_ptr<AVFrame> frame;
+        frame.swap(m_pending);
+        m_yuv.upload(frame.get());
+        m_uploadNs += timer.nsecsElapsed();
+        ++m_uploadCount;
+        timer.restart();
+    }
+    if (!m_yuv.hasFrame())
+    {
+        return;
+    }
+
+    m_yuv.draw(static_cast<int>(width() * devicePixelRatioF()), static_cast<int>(height() * devicePixelRatioF()),
+               m_visibleRect, m_smooth);
+    m_drawNs += timer.nsecsElapsed();
+
+    if (++m_drawCount >= GL_STATS_INTERVAL)
+    {
+        StreamStats* stats = StreamStats::instance();
+        if (m_uploadCount > 0)
+        {
+            stats->setValue("paint.gl.uploadUs", m_uploadNs / 1000 / m_uploadCount);
+        }
+        stats->setValue("paint.gl.drawUs", m_drawNs / 1000 / m_drawCount);
+        m_uploadNs = 0;
+        m_drawNs = 0;
+        m_uploadCount = 0;
+        m_drawCount = 0;
+    }
+}
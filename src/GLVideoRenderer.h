@@ -0,0 +1,53 @@
+#ifndef GLVIDEORENDERER_H
+#define GLVIDEORENDERER_H
+
+#include <QOpenGLWidget>
+#include <QOpenGLFunctions>
+#include <memory>
+
+#include "FrameMailbox.h"
+#include "GLYuvProgram.h"
+
+// OpenGL ES 2.0 视频渲染
+// 上传和色彩转换在 GLYuvProgram 中，CPU 上不再有色彩转换和 QPainter 缩放。
+// 作为 VideoWidget 的子控件盖在显示区域上，不接收输入事件。
+class GLVideoRenderer : public QOpenGLWidget, protected QOpenGLFunctions
+{
+    Q_OBJECT
+
+public:
+    explicit GLVideoRenderer(QWidget* parent = nullptr);
+    ~GLVideoRenderer();
+
+    // 当前平台能否创建 OpenGL 上下文
+    static bool isAvailable();
+
+    // frame.yuv 不能为空；帧在下一次 paintGL 时上传，上传后即释放引用
+    void setFrame(const VideoFrame& frame);
+    void setSmoothScaling(bool smooth);
+    // 放大时只显示源画面的这一块（归一化坐标），纹理仍整帧上传
+    void setVisibleRect(const QRectF& rect);
+
+signals:
+    // 着色器编译或链接失败，VideoWidget 收到后回退到光栅绘制
+    void initFailed(const QString& reason);
+
+protected:
+    void initializeGL() override;
+    void paintGL() override;
+
+private:
+    GLYuvProgram m_yuv;
+    bool m_ready = false;
+    std::shared_ptr<AVFrame> m_pending;
+    bool m_smooth = true;
+    QRectF m_visibleRect = QRectF(0, 0, 1, 1);
+
+    // 上传和绘制耗时，定期写入 StreamStats
+    qint64 m_uploadNs = 0;
+    qint64 m_drawNs = 0;
+    int m_uploadCount = 0;
+    int m_drawCount = 0;
+};
+
+#endif // GLVIDEORENDERER_H
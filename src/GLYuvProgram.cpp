@@ -0,0 +1,219 @@
+#include "GLYuvProgram.h"
+
+#include <QGenericMatrix>
+#include <QVector2D>
+#include <QVector4D>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+static const char* VERTEX_SHADER =
+    "attribute vec2 a_position;\n"
+    "attribute vec2 a_texCoord;\n"
+    "uniform vec2 u_scaleY;\n"
+    "uniform vec2 u_scaleC;\n"
+    "uniform vec4 u_view;\n"
+    "varying vec2 v_texY;\n"
+    "varying vec2 v_texC;\n"
+    "void main()\n"
+    "{\n"
+    "    gl_Position = vec4(a_position, 0.0, 1.0);\n"
+    "    vec2 t = u_view.xy + a_texCoord * u_view.zw;\n"
+    "    v_texY = t * u_scaleY;\n"
+    "    v_texC = t * u_scaleC;\n"
+    "}\n";
+
+static const char* FRAGMENT_SHADER =
+    "#ifdef GL_ES\n"
+    "#ifdef GL_FRAGMENT_PRECISION_HIGH\n"
+    "precision highp float;\n"
+    "#else\n"
+    "precision mediump float;\n"
+    "#endif\n"
+    "#endif\n"
+    "varying vec2 v_texY;\n"
+    "varying vec2 v_texC;\n"
+    "uniform sampler2D u_texY;\n"
+    "uniform sampler2D u_texU;\n"
+    "uniform sampler2D u_texV;\n"
+    "uniform float u_nv12;\n"
+    "uniform vec2 u_maxY;\n"
+    "uniform vec2 u_maxC;\n"
+    "uniform mat3 u_matrix;\n"
+    "uniform vec3 u_offset;\n"
+    "void main()\n"
+    "{\n"
+    // 纹理按整行跨度上传，最后一个有效像素的中心之外双线性采样会混入行尾填充
+    "    vec2 texY = min(v_texY, u_maxY);\n"
+    "    vec2 texC = min(v_texC, u_maxC);\n"
+    "    float y = texture2D(u_texY, texY).r;\n"
+    "    vec4 c = texture2D(u_texU, texC);\n"
+    // NV12 的 UV 交错平面以 LUMINANCE_ALPHA 上传，U 在 r、V 在 a
+    "    vec2 uv = u_nv12 > 0.5 ? c.ra : vec2(c.r, texture2D(u_texV, texC).r);\n"
+    "    vec3 rgb = u_matrix * (vec3(y, uv) - u_offset);\n"
+    "    gl_FragColor = vec4(clamp(rgb, 0.0, 1.0), 1.0);\n"
+    "}\n";
+
+// 全屏四边形，纹理第 0 行（画面顶部）对应 y = 1
+static const GLfloat QUAD_POSITIONS[] = { -1.0f, -1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f };
+static const GLfloat QUAD_TEXCOORDS[] = { 0.0f, 1.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 0.0f };
+
+// BT.601 YUV -> RGB，行优先
+static const float BT601_LIMITED[] = {
+    1.164f,  0.000f,  1.596f,
+    1.164f, -0.392f, -0.813f,
+    1.164f,  2.017f,  0.000f
+};
+static const float BT601_FULL[] = {
+    1.000f,  0.000f,  1.402f,
+    1.000f, -0.344f, -0.714f,
+    1.000f,  1.772f,  0.000f
+};
+
+bool GLYuvProgram::initialize()
+{
+    initializeOpenGLFunctions();
+
+    if (!m_program.addShaderFromSourceCode(QOpenGLShader::Vertex, VERTEX_SHADER)
+        || !m_program.addShaderFromSourceCode(QOpenGLShader::Fragment, FRAGMENT_SHADER)
+        || !m_program.link())
+    {
+        return false;
+    }
+
+    for (TextureSet& set : m_textures)
+    {
+        glGenTextures(3, set.planes);
+        for (GLuint texture : set.planes)
+        {
+            glBindTexture(GL_TEXTURE_2D, texture);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        }
+    }
+    m_ready = true;
+    return true;
+}
+
+void GLYuvProgram::destroy()
+{
+    if (!m_ready)
+    {
+        return;
+    }
+    for (TextureSet& set : m_textures)
+    {
+        glDeleteTextures(3, set.planes);
+        set = TextureSet();
+    }
+    m_program.removeAllShaders();
+    m_ready = false;
+    m_hasFrame = false;
+}
+
+void GLYuvProgram::uploadPlane(TextureSet& set, int plane, GLenum format, int width, int height,
+                               const uint8_t* data)
+{
+    glBindTexture(GL_TEXTURE_2D, set.planes[plane]);
+    QSize size(width, height);
+    if (set.sizes[plane] != size)
+    {
+        // 尺寸变化时重新分配存储，之后同尺寸的帧只做 SubImage 更新
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        set.sizes[plane] = size;
+    }
+    else
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, width, height, format, GL_UNSIGNED_BYTE, data);
+    }
+}
+
+void GLYuvProgram::upload(const AVFrame* frame)
+{
+    if (!m_ready)
+    {
+        return;
+    }
+    int next = m_hasFrame ? (m_current ^ 1) : m_current;
+    TextureSet& set = m_textures[next];
+
+    // GLES2 没有 UNPACK_ROW_LENGTH，按行跨度整行上传，采样坐标按比例裁掉填充
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    int chromaWidth = (frame->width + 1) / 2;
+    int chromaHeight = (frame->height + 1) / 2;
+    bool nv12 = frame->format == AV_PIX_FMT_NV12;
+
+    uploadPlane(set, 0, GL_LUMINANCE, frame->linesize[0], frame->height, frame->data[0]);
+    int chromaTexWidth;
+    if (nv12)
+    {
+        chromaTexWidth = frame->linesize[1] / 2;
+        uploadPlane(set, 1, GL_LUMINANCE_ALPHA, chromaTexWidth, chromaHeight, frame->data[1]);
+    }
+    else
+    {
+        chromaTexWidth = frame->linesize[1];
+        uploadPlane(set, 1, GL_LUMINANCE, frame->linesize[1], chromaHeight, frame->data[1]);
+        uploadPlane(set, 2, GL_LUMINANCE, frame->linesize[2], chromaHeight, frame->data[2]);
+    }
+    m_current = next;
+    m_hasFrame = true;
+
+    m_layout.size = QSize(frame->width, frame->height);
+    m_layout.nv12 = nv12;
+    m_layout.fullRange = frame->format == AV_PIX_FMT_YUVJ420P || frame->color_range == AVCOL_RANGE_JPEG;
+    // 每个色度样本对应 2x2 个亮度像素，宽高为奇数时最后一列/行色度只覆盖一个亮度像素，
+    // 所以色度坐标按亮度尺寸的一半映射，而不是把色度平面拉伸到整个画面
+    m_layout.scaleY = QSizeF(static_cast<qreal>(frame->width) / frame->linesize[0], 1.0);
+    m_layout.scaleC = QSizeF(frame->width / (2.0 * chromaTexWidth), frame->height / (2.0 * chromaHeight));
+    // 最后一个有效纹素的中心
+    m_layout.maxY = QSizeF((frame->width - 0.5) / frame->linesize[0], (frame->height - 0.5) / frame->height);
+    m_layout.maxC = QSizeF((chromaWidth - 0.5) / chromaTexWidth, (chromaHeight - 0.5) / chromaHeight);
+}
+
+void GLYuvProgram::draw(int viewportWidth, int viewportHeight, const QRectF& view, bool smooth)
+{
+    if (!m_ready || !m_hasFrame)
+    {
+        return;
+    }
+    const TextureSet& set = m_textures[m_current];
+    glViewport(0, 0, viewportWidth, viewportHeight);
+    m_program.bind();
+
+    GLint filter = smooth ? GL_LINEAR : GL_NEAREST;
+    for (int plane = 0; plane < 3; ++plane)
+    {
+        glActiveTexture(GL_TEXTURE0 + plane);
+        glBindTexture(GL_TEXTURE_2D, set.planes[plane]);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    }
+    glActiveTexture(GL_TEXTURE0);
+
+    m_program.setUniformValue("u_texY", 0);
+    m_program.setUniformValue("u_texU", 1);
+    m_program.setUniformValue("u_texV", 2);
+    m_program.setUniformValue("u_nv12", m_layout.nv12 ? 1.0f : 0.0f);
+    m_program.setUniformValue("u_scaleY", QVector2D(m_layout.scaleY.width(), m_layout.scaleY.height()));
+    m_program.setUniformValue("u_scaleC", QVector2D(m_layout.scaleC.width(), m_layout.scaleC.height()));
+    m_program.setUniformValue("u_maxY", QVector2D(m_layout.maxY.width(), m_layout.maxY.height()));
+    m_program.setUniformValue("u_maxC", QVector2D(m_layout.maxC.width(), m_layout.maxC.height()));
+    m_program.setUniformValue("u_view", QVector4D(view.x(), view.y(), view.width(), view.height()));
+    m_program.setUniformValue("u_matrix", QMatrix3x3(m_layout.fullRange ? BT601_FULL : BT601_LIMITED));
+    m_program.setUniformValue("u_offset", m_layout.fullRange ? 0.0f : 16.0f / 255.0f,
+                              128.0f / 255.0f, 128.0f / 255.0f);
+
+    int position = m_program.attributeLocation("a_position");
+    int texCoord = m_program.attributeLocation("a_texCoord");
+    m_program.enableAttributeArray(position);
+    m_program.enableAttributeArray(texCoord);
+    m_program.setAttributeArray(position, QUAD_POSITIONS, 2);
+    m_program.setAttributeArray(texCoord, QUAD_TEXCOORDS, 2);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    m_program.disableAttributeArray(position);
+    m_program.disableAttributeArray(texCoord);
+    m_program.release();
+}
@@ -0,0 +1,72 @@
+#ifndef GLYUVPROGRAM_H
+#define GLYUVPROGRAM_H
+
+#include <QOpenGLFunctions>
+#include <QOpenGLShaderProgram>
+#include <QRectF>
+#include <QSize>
+
+struct AVFrame;
+
+// 在当前 OpenGL 上下文中绘制 YUV420P/NV12 帧
+// Y/U/V（NV12 为 Y/UV）平面直接作为亮度纹理上传，片元着色器做色彩转换，缩放交给纹理采样。
+// GLES2 没有 PBO，纹理分两组轮流上传，写入下一帧时不必等 GPU 读完正在显示的那组。
+// 色彩系数与 CPU 路径一致: BT.601，有限范围或全范围（YUVJ）。
+// 与窗口无关: GLVideoRenderer 画到控件上，单元测试画到离屏 FBO 上与 CPU 路径比较。
+// 所有接口都要求调用时上下文为当前。
+class GLYuvProgram : protected QOpenGLFunctions
+{
+public:
+    GLYuvProgram() = default;
+
+    // 编译着色器并创建纹理，失败时 log() 给出原因
+    bool initialize();
+    // 释放纹理和着色器
+    void destroy();
+    QString log() const { return m_program.log(); }
+
+    bool hasFrame() const { return m_hasFrame; }
+    QSize frameSize() const { return m_layout.size; }
+    bool isNv12() const { return m_layout.nv12; }
+    bool isFullRange() const { return m_layout.fullRange; }
+
+    // 上传到 GPU 当前没有在读的那组纹理，之后的 draw 使用这一帧；返回后即可释放 frame
+    void upload(const AVFrame* frame);
+    // 画到当前帧缓冲 (0, 0, viewportWidth, viewportHeight) 的视口
+    // view 为要显示的源画面区域（归一化坐标），smooth 选择双线性或最近邻采样
+    void draw(int viewportWidth, int viewportHeight, const QRectF& view, bool smooth);
+
+    GLYuvProgram(const GLYuvProgram&) = delete;
+    GLYuvProgram& operator=(const GLYuvProgram&) = delete;
+
+private:
+    // 一组平面纹理，尺寸按行跨度分配，只在分辨率或跨度变化时重新分配
+    struct TextureSet
+    {
+        GLuint planes[3] = { 0, 0, 0 };
+        QSize sizes[3];
+    };
+
+    // 已上传帧的布局，纹理宽度是行跨度，采样坐标按 scale 映射到有效区域，并夹在 max 以内
+    struct FrameLayout
+    {
+        QSize size;
+        bool nv12 = false;
+        bool fullRange = false;
+        QSizeF scaleY = QSizeF(1, 1);
+        QSizeF scaleC = QSizeF(1, 1);
+        QSizeF maxY = QSizeF(1, 1);
+        QSizeF maxC = QSizeF(1, 1);
+    };
+
+    void uploadPlane(TextureSet& set, int plane, GLenum format, int width, int height, const uint8_t* data);
+
+    QOpenGLShaderProgram m_program;
+    bool m_ready = false;
+    TextureSet m_textures[2];
+    int m_current = 0;
+    bool m_hasFrame = false;
+    FrameLayout m_layout;
+};
+
+#endif // GLYUVPROGRAM_H
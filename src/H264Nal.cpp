@@ -0,0 +1,266 @@
+#include "H264Nal.h"
+
+#include <QtGlobal>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define NAL_HAVE_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define NAL_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+int findH264StartCodeBytewise(const uint8_t* data, int size, int from)
+{
+    // H264 NAL起始码通常是 00 00 00 01 或 00 00 01，这里统一找 00 00 01
+    for (int i = from; i + 2 < size; ++i) {
+        if (data[i] == 0 && data[i+1] == 0 && data[i+2] == 1) {
+            return i;
+        }
+    }
+    return size;
+}
+
+// 熵编码数据里 0x01 很少出现，memchr（libc 内部已向量化）直接跳到候选位置再检查前两个字节
+int findH264StartCodeMemchr(const uint8_t* data, int size, int from)
+{
+    int i = from + 2;
+    while (i < size) {
+        const void* hit = memchr(data + i, 1, size - i);
+        if (!hit) {
+            break;
+        }
+        i = int(static_cast<const uint8_t*>(hit) - data);
+        if (data[i-1] == 0 && data[i-2] == 0) {
+            return i - 2;
+        }
+        ++i;
+    }
+    return size;
+}
+
+int findH264StartCode(const uint8_t* data, int size, int from)
+{
+    int i = from;
+
+    // 在偏移 0、1、2 处各载入 16 字节，同时比较 00、00、01，得到的掩码里每一位就是一个真正的起始码，
+    // 不需要再逐字节确认；一个块覆盖从 i 到 i + 15 开始的起始码，最远读到 i + 17
+#if defined(NAL_HAVE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    for (; i + 18 <= size; i += 16) {
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 1));
+        __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i + 2));
+        __m128i hits = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero), _mm_cmpeq_epi8(b1, zero)),
+                                     _mm_cmpeq_epi8(b2, one));
+        int mask = _mm_movemask_epi8(hits);
+        if (mask) {
+            // 最低位即最靠前的起始码
+            int offset = 0;
+            while (!(mask & 1)) {
+                mask >>= 1;
+                ++offset;
+            }
+            return i + offset;
+        }
+    }
+#elif defined(NAL_HAVE_NEON)
+    const uint8x16_t one = vdupq_n_u8(1);
+    for (; i + 18 <= size; i += 16) {
+        uint8x16_t hits = vandq_u8(vandq_u8(vceqzq_u8(vld1q_u8(data + i)), vceqzq_u8(vld1q_u8(data + i + 1))),
+                                   vceqq_u8(vld1q_u8(data + i + 2), one));
+        // 每个字节压成 4 位，得到 64 位掩码
+        uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(hits), 4)), 0);
+        if (mask) {
+            int offset = 0;
+            while (!(mask & 0xF)) {
+                mask >>= 4;
+                ++offset;
+            }
+            return i + offset;
+        }
+    }
+#else
+    return findH264StartCodeMemchr(data, size, from);
+#endif
+
+    // 不足一个块的尾部
+    return findH264StartCodeBytewise(data, size, i);
+}
+
+const char* h264StartCodeScannerName()
+{
+#if defined(NAL_HAVE_SSE2)
+    return "SSE2";
+#elif defined(NAL_HAVE_NEON)
+    return "NEON";
+#else
+    return "memchr";
+#endif
+}
+
+void indexH264Nals(const uint8_t* data, int size, NalIndex& index)
+{
+    index.clear();
+
+    int pos = findH264StartCode(data, size, 0);
+    while (pos + 3 < size) {
+        NalUnit nal;
+        nal.offset = pos + 3;
+        // NAL Unit Type 位于字节的低 5 位，nal_ref_idc 位于 bit5~6
+        nal.type = data[nal.offset] & 0x1F;
+        nal.refIdc = (data[nal.offset] >> 5) & 0x03;
+
+        // 跳过这个 NAL 头，继续寻找下一个；四字节起始码的前导 0 不计入本 NAL
+        pos = findH264StartCode(data, size, nal.offset);
+        int end = pos;
+        while (end > nal.offset + 1 && data[end - 1] == 0) {
+            --end;
+        }
+        nal.size = end - nal.offset;
+        index.append(nal);
+    }
+}
+
+// 按字节读取 RBSP，跳过防竞争字节（00 00 03 中的 03）
+struct RbspReader
+{
+    const uint8_t* data;
+    int size;
+    int pos;
+    int zeros;
+
+    bool atEnd() const { return pos >= size; }
+
+    int readByte()
+    {
+        if (zeros >= 2 && pos < size && data[pos] == 3) {
+            ++pos;
+            zeros = 0;
+        }
+        if (pos >= size) {
+            return -1;
+        }
+        uint8_t b = data[pos++];
+        zeros = b == 0 ? zeros + 1 : 0;
+        return b;
+    }
+};
+
+// 读 Exp-Golomb 无符号数 ue(v)
+static int readUe(const uint8_t* bits, int byteCount, int& bitPos)
+{
+    int leadingZeros = 0;
+    while (bitPos < byteCount * 8 && !((bits[bitPos >> 3] >> (7 - (bitPos & 7))) & 1)) {
+        ++leadingZeros;
+        ++bitPos;
+    }
+    ++bitPos;
+    if (leadingZeros > 16) {
+        return -1;
+    }
+    int value = 0;
+    for (int i = 0; i < leadingZeros; ++i, ++bitPos) {
+        if (bitPos >= byteCount * 8) {
+            return -1;
+        }
+        value = (value << 1) | ((bits[bitPos >> 3] >> (7 - (bitPos & 7))) & 1);
+    }
+    return (1 << leadingZeros) - 1 + value;
+}
+
+bool parseH264RecoveryPoint(const uint8_t* nal, int size, int* recoveryFrameCnt)
+{
+    RbspReader reader = { nal, size, 1, 0 };   // 跳过 NAL 头
+
+    // sei_message(): payloadType 和 payloadSize 都以若干个 0xFF 加最后一个字节编码
+    while (!reader.atEnd()) {
+        int payloadType = 0;
+        int b = reader.readByte();
+        while (b == 0xFF) {
+            payloadType += 255;
+            b = reader.readByte();
+        }
+        if (b < 0 || (b == 0x80 && reader.atEnd())) {
+            break;  // rbsp_trailing_bits
+        }
+        payloadType += b;
+
+        int payloadSize = 0;
+        b = reader.readByte();
+        while (b == 0xFF) {
+            payloadSize += 255;
+            b = reader.readByte();
+        }
+        if (b < 0) {
+            break;
+        }
+        payloadSize += b;
+
+        if (payloadType == 6) {
+            // recovery_point(): recovery_frame_cnt ue(v), exact_match_flag, broken_link_flag, ...
+            uint8_t payload[8] = { 0 };
+            int count = qMin(payloadSize, int(sizeof(payload)));
+            for (int i = 0; i < count; ++i) {
+                int v = reader.readByte();
+                if (v < 0) {
+                    return false;
+                }
+                payload[i] = uint8_t(v);
+            }
+            int bitPos = 0;
+            int frameCnt = readUe(payload, count, bitPos);
+            if (frameCnt < 0) {
+                return false;
+            }
+            *recoveryFrameCnt = frameCnt;
+            return true;
+        }
+
+        for (int i = 0; i < payloadSize; ++i) {
+            if (reader.readByte() < 0) {
+                return false;
+            }
+        }
+    }
+    return false;
+}
+
+PacketInfo summarizeH264Nals(const uint8_t* data, const NalIndex& index)
+{
+    PacketInfo info;
+    for (const NalUnit& nal : index) {
+        if (isH264VclNal(nal.type)) {
+            if (!info.hasVcl && nal.size > 1) {
+                info.startsPicture = isH264FirstSliceOfPicture(data[nal.offset + 1]);
+            }
+            info.hasVcl = true;
+            if (nal.refIdc != 0) {
+                info.isReference = true;
+            }
+        }
+        // Type 5: IDR(关键帧)
+        if (nal.type == H264_NAL_IDR_SLICE) {
+            info.hasIdr = true;
+        }
+        // Type 7: SPS(序列参数集，通常关键帧前会有这个)
+        if (nal.type == H264_NAL_SPS) {
+            info.hasSps = true;
+        }
+        // Type 6: SEI，帧内刷新码流用恢复点代替 IDR
+        if (nal.type == H264_NAL_SEI && !info.hasRecoveryPoint) {
+            info.hasRecoveryPoint = parseH264RecoveryPoint(data + nal.offset, nal.size, &info.recoveryFrameCnt);
+        }
+    }
+    return info;
+}
+
+// 手动分析H264数据流
+PacketInfo parseH264Packet(const uint8_t* data, int size)
+{
+    NalIndex index;
+    indexH264Nals(data, size, index);
+    return summarizeH264Nals(data, index);
+}
@@ -0,0 +1,61 @@
+#ifndef H264NAL_H
+#define H264NAL_H
+
+#include <QByteArray>
+#include <cstdint>
+
+#include "NalIndex.h"
+
+// H.264 NAL 单元类型
+enum H264NalType
+{
+    H264_NAL_SLICE     = 1,
+    H264_NAL_IDR_SLICE = 5,
+    H264_NAL_SEI       = 6,
+    H264_NAL_SPS       = 7,
+    H264_NAL_PPS       = 8,
+    H264_NAL_AUD       = 9
+};
+
+// 从 from 开始查找下一个 00 00 01 起始码，返回其首字节位置，找不到返回 size
+// x86 用 SSE2、ARM64 用 NEON 每次比较 16 字节，其它平台用 memchr 跳到 0x01 再回看
+int findH264StartCode(const uint8_t* data, int size, int from);
+// 逐字节的参考实现与 memchr 实现，用于对比测试
+int findH264StartCodeBytewise(const uint8_t* data, int size, int from);
+int findH264StartCodeMemchr(const uint8_t* data, int size, int from);
+// 当前平台使用的扫描实现名称
+const char* h264StartCodeScannerName();
+
+// 建立包内全部 NAL 的索引（先清空 index）
+void indexH264Nals(const uint8_t* data, int size, NalIndex& index);
+
+// 在 SEI NAL 中查找恢复点消息（payloadType 6），nal 指向 NAL 头字节
+// 找到时返回 true 并写出 recovery_frame_cnt
+bool parseH264RecoveryPoint(const uint8_t* nal, int size, int* recoveryFrameCnt);
+
+// 由索引得到包的结构概要
+PacketInfo summarizeH264Nals(const uint8_t* data, const NalIndex& index);
+
+// 扫描 Annex-B 数据包中的全部 NAL 头（只需要概要时使用）
+PacketInfo parseH264Packet(const uint8_t* data, int size);
+
+// 是否为图像数据（片）
+inline bool isH264VclNal(int type)
+{
+    return type == H264_NAL_SLICE || type == H264_NAL_IDR_SLICE;
+}
+
+// 片头第一个字段 first_mb_in_slice 为 ue(v)，值为 0 时编码为单个 1 比特
+// payload 指向 NAL 头之后的第一个字节
+inline bool isH264FirstSliceOfPicture(uint8_t payload)
+{
+    return (payload & 0x80) != 0;
+}
+
+// 判断是否包含关键帧(IDR、SPS或恢复点)，可以从这里开始解码
+inline bool isH264KeyFrame(const QByteArray& data)
+{
+    return isRandomAccessPoint(parseH264Packet(reinterpret_cast<const uint8_t*>(data.constData()), data.size()));
+}
+
+#endif // H264NAL_H
@@ -0,0 +1,65 @@
+#include "MemoryBudget.h"
+#include "StreamStats.h"
+
+static const char* SUBSYSTEM_NAMES[] = { "receiveBuffer", "packetQueue", "framePool", "sendQueue" };
+
+MemoryBudget::MemoryBudget(const DeskMemoryBudget& config)
+{
+    const qint64 kb = 1024;
+    const qint64 mb = 1024 * 1024;
+    m_limit[BudgetReceiveBuffer] = qMax(1, config.receiveBufferMB) * mb;
+    m_limit[BudgetPacketQueue] = qMax(1, config.packetQueueMB) * mb;
+    m_limit[BudgetFramePool] = qMax(1, config.framePoolMB) * mb;
+    m_limit[BudgetSendQueue] = qMax(1, config.sendQueueKB) * kb;
+    m_totalLimit = qMax(1, config.totalMB) * mb;
+    for (int i = 0; i < BudgetCount; ++i)
+    {
+        m_usage[i] = 0;
+        m_overruns[i] = 0;
+    }
+}
+
+const char* MemoryBudget::subsystemName(Subsystem subsystem)
+{
+    return SUBSYSTEM_NAMES[subsystem];
+}
+
+void MemoryBudget::setUsage(Subsystem subsystem, qint64 bytes)
+{
+    m_usage[subsystem].store(bytes, std::memory_order_relaxed);
+}
+
+qint64 MemoryBudget::totalUsage() const
+{
+    qint64 total = 0;
+    for (int i = 0; i < BudgetCount; ++i)
+    {
+        total += m_usage[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+bool MemoryBudget::withinLimit(Subsystem subsystem, qint64 extraBytes) const
+{
+    return usage(subsystem) + extraBytes <= m_limit[subsystem]
+        && totalUsage() + extraBytes <= m_totalLimit;
+}
+
+void MemoryBudget::countOverrun(Subsystem subsystem)
+{
+    m_overruns[subsystem].fetch_add(1, std::memory_order_relaxed);
+}
+
+void MemoryBudget::report() const
+{
+    StreamStats* stats = StreamStats::instance();
+    for (int i = 0; i < BudgetCount; ++i)
+    {
+        QString prefix = QString("memory.%1.").arg(SUBSYSTEM_NAMES[i]);
+        stats->setValue(prefix + "usedKB", m_usage[i].load(std::memory_order_relaxed) / 1024);
+        stats->setValue(prefix + "limitKB", m_limit[i] / 1024);
+        stats->setValue(prefix + "overruns", m_overruns[i].load(std::memory_order_relaxed));
+    }
+    stats->setValue("memory.totalKB", totalUsage() / 1024);
+    stats->setValue("memory.limitKB", m_totalLimit / 1024);
+}
@@ -0,0 +1,58 @@
+#ifndef MEMORYBUDGET_H
+#define MEMORYBUDGET_H
+
+#include <QtGlobal>
+#include <atomic>
+
+#include "DeskDefine.h"
+
+// 视频会话的内存预算
+// 各子系统上报自己当前占用的字节数，超出本子系统的预留额度或会话总额度时由子系统按各自策略处理:
+//   BudgetReceiveBuffer  包队列积压时暂停读取 socket（TCP 窗口收紧，由服务端放慢发送）
+//   BudgetPacketQueue    按 GOP 结构丢包，见 PacketQueue::trim
+//   BudgetFramePool      丢弃新解码的帧，等显示端释放旧帧
+//   BudgetSendQueue      丢弃可合并的输入事件（鼠标/触摸移动）
+// 所有接口线程安全。
+class MemoryBudget
+{
+public:
+    enum Subsystem
+    {
+        BudgetReceiveBuffer = 0,
+        BudgetPacketQueue,
+        BudgetFramePool,
+        BudgetSendQueue,
+        BudgetCount
+    };
+
+    explicit MemoryBudget(const DeskMemoryBudget& config);
+
+    static const char* subsystemName(Subsystem subsystem);
+
+    // 覆盖写入子系统当前占用
+    void setUsage(Subsystem subsystem, qint64 bytes);
+
+    // 再占用 extraBytes 后是否仍在本子系统额度和总额度之内
+    bool withinLimit(Subsystem subsystem, qint64 extraBytes = 0) const;
+    // 子系统因超出额度执行了一次丢弃或暂停
+    void countOverrun(Subsystem subsystem);
+
+    qint64 usage(Subsystem subsystem) const { return m_usage[subsystem].load(std::memory_order_relaxed); }
+    qint64 limit(Subsystem subsystem) const { return m_limit[subsystem]; }
+    qint64 totalUsage() const;
+    qint64 totalLimit() const { return m_totalLimit; }
+
+    // 当前占用、额度和超限次数写入 StreamStats（memory.*）
+    void report() const;
+
+    MemoryBudget(const MemoryBudget&) = delete;
+    MemoryBudget& operator=(const MemoryBudget&) = delete;
+
+private:
+    qint64 m_limit[BudgetCount];
+    qint64 m_totalLimit;
+    std::atomic<qint64> m_usage[BudgetCount];
+    std::atomic<quint64> m_overruns[BudgetCount];
+};
+
+#endif // MEMORYBUDGET_H
@@ -0,0 +1,355 @@
+#include "MjpegDecodePool.h"
+#include "DeskDefine.h"
+#include "LogWidget.h"
+#include "PacketPool.h"
+#include "StreamStats.h"
+#include "YuvConverter.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libswscale/swscale.h>
+}
+
+#include <QElapsedTimer>
+
+// 每个工作线程的解码状态，只在该线程内访问
+struct MjpegDecodePool::Worker
+{
+    AVCodecContext* codecCtx = nullptr;
+    AVFrame* frame = nullptr;
+    // 引用 frame 缓冲区的可见区域裁剪视图
+    AVFrame* cropFrame = nullptr;
+    AVPacket* packet = nullptr;
+    PacketPool packetPool;
+    SwsContext* swsCtx = nullptr;
+    YuvConverter yuvConverter;
+
+    ~Worker()
+    {
+        sws_freeContext(swsCtx);
+        av_frame_free(&cropFrame);
+        av_frame_free(&frame);
+        av_packet_free(&packet);
+        avcodec_free_context(&codecCtx);
+    }
+};
+
+MjpegDecodePool::MjpegDecodePool(int threadCount, int maxPending, QImage::Format imageFormat,
+                                 AVPixelFormat swsFormat, const PublishFunc& publish,
+                                 const std::shared_ptr<MemoryBudget>& budget)
+    : m_maxPending(qMax(1, maxPending))
+    , m_imageFormat(imageFormat)
+    , m_swsFormat(swsFormat)
+    , m_publish(publish)
+    , m_budget(budget)
+    , m_framePool(2 * qMax(1, threadCount) + 3)
+{
+    threadCount = qMax(1, threadCount);
+    const AVCodec* codec = avcodec_find_decoder(AV_CODEC_ID_MJPEG);
+    for (int i = 0; i < threadCount; ++i)
+    {
+        Worker* worker = new Worker;
+        worker->frame = av_frame_alloc();
+        worker->cropFrame = av_frame_alloc();
+        worker->packet = av_packet_alloc();
+        worker->codecCtx = codec ? avcodec_alloc_context3(codec) : nullptr;
+        if (worker->codecCtx)
+        {
+            // 并行度来自多帧同时解码，单个解码器只用一个线程
+            worker->codecCtx->thread_count = 1;
+            if (avcodec_open2(worker->codecCtx, codec, nullptr) < 0)
+            {
+                avcodec_free_context(&worker->codecCtx);
+            }
+        }
+        if (!worker->codecCtx || !worker->frame || !worker->cropFrame || !worker->packet)
+        {
+            LogWidget::instance()->addLog(QString("Could not open MJPEG decoder %1").arg(i), LogWidget::Error);
+        }
+        m_workers.append(worker);
+    }
+
+    for (int i = 0; i < threadCount; ++i)
+    {
+        QThread* thread = QThread::create([this, i]() {
+            workerLoop(i);
+        });
+        thread->setObjectName(QString("MjpegWorker%1").arg(i));
+        thread->start();
+        m_threads.append(thread);
+    }
+}
+
+MjpegDecodePool::~MjpegDecodePool()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_jobs.clear();
+        m_jobCond.wakeAll();
+    }
+
+    for (QThread* thread : m_threads)
+    {
+        thread->wait();
+        delete thread;
+    }
+    m_threads.clear();
+
+    qDeleteAll(m_workers);
+    m_workers.clear();
+}
+
+void MjpegDecodePool::submit(const QByteArray& data, qint64 receivedNs, const QSize& targetSize,
+                             const QRectF& visibleRect)
+{
+    Job job;
+    job.data = data;
+    job.receivedNs = receivedNs;
+    job.targetSize = targetSize;
+    job.visibleRect = visibleRect;
+
+    Job dropped;
+    bool hasDropped = false;
+    {
+        QMutexLocker locker(&m_mutex);
+        job.seq = m_nextSeq++;
+        // 解码跟不上时丢最旧的未开始帧: JPEG 帧互不依赖，丢弃不影响后续帧
+        if (m_jobs.size() >= m_maxPending)
+        {
+            dropped = m_jobs.dequeue();
+            hasDropped = true;
+        }
+        m_jobs.enqueue(job);
+        m_jobCond.wakeOne();
+    }
+
+    if (hasDropped)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        complete(dropped.seq, VideoFrame());
+    }
+}
+
+void MjpegDecodePool::clear()
+{
+    QQueue<Job> jobs;
+    {
+        QMutexLocker locker(&m_mutex);
+        jobs.swap(m_jobs);
+    }
+
+    // 序号仍需在排序缓冲里占位，否则后面已完成的帧会一直等待
+    for (const Job& job : jobs)
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        complete(job.seq, VideoFrame());
+    }
+}
+
+void MjpegDecodePool::waitIdle()
+{
+    quint64 submitted;
+    {
+        QMutexLocker locker(&m_mutex);
+        submitted = m_nextSeq;
+    }
+    QMutexLocker locker(&m_reorderMutex);
+    while (m_nextPublish < submitted)
+    {
+        m_idleCond.wait(&m_reorderMutex);
+    }
+}
+
+qint64 MjpegDecodePool::averageDecodeNs() const
+{
+    quint64 count = m_decoded.load(std::memory_order_relaxed) + m_failed.load(std::memory_order_relaxed);
+    return count > 0 ? m_decodeNs.load(std::memory_order_relaxed) / static_cast<qint64>(count) : 0;
+}
+
+void MjpegDecodePool::workerLoop(int index)
+{
+    forever
+    {
+        Job job;
+        {
+            QMutexLocker locker(&m_mutex);
+            while (!m_quit && m_jobs.isEmpty())
+            {
+                m_jobCond.wait(&m_mutex);
+            }
+            if (m_quit)
+            {
+                return;
+            }
+            job = m_jobs.dequeue();
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+        VideoFrame frame;
+        bool decoded = decodeJob(index, job, frame);
+        m_decodeNs.fetch_add(timer.nsecsElapsed(), std::memory_order_relaxed);
+        if (!decoded)
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+        else if (frame.image.isNull())
+        {
+            m_failed.fetch_add(1, std::memory_order_relaxed);
+        }
+        else
+        {
+            m_decoded.fetch_add(1, std::memory_order_relaxed);
+        }
+        complete(job.seq, frame);
+    }
+}
+
+bool MjpegDecodePool::decodeJob(int index, const Job& job, VideoFrame& frame)
+{
+    Worker* worker = m_workers[index];
+    if (!worker->codecCtx || !worker->frame || !worker->cropFrame || !worker->packet)
+    {
+        return true;
+    }
+
+    if (!worker->packetPool.fill(worker->packet, reinterpret_cast<const uint8_t*>(job.data.constData()),
+                                 job.data.size()))
+    {
+        return true;
+    }
+    int ret = avcodec_send_packet(worker->codecCtx, worker->packet);
+    av_packet_unref(worker->packet);
+    if (ret < 0)
+    {
+        return true;
+    }
+
+    AVFrame* decoded = worker->frame;
+    if (avcodec_receive_frame(worker->codecCtx, decoded) < 0)
+    {
+        return true;
+    }
+
+    QSize sourceSize(decoded->width, decoded->height);
+    QSize outSize = deskLetterboxRect(job.targetSize, sourceSize).size();
+    if (outSize.isEmpty())
+    {
+        outSize = sourceSize;
+    }
+    // 与 VideoDecoderWorker::convertAndPublish 相同: 放大时只转换可见区域，输出不超过可见区域的源尺寸
+    QRect crop = deskVisibleSourceRect(job.visibleRect, sourceSize);
+    bool cropped = crop.size() != sourceSize;
+    if (cropped)
+    {
+        outSize = outSize.boundedTo(crop.size());
+    }
+
+    // 没有空闲缓冲区可复用、再分配会超出预算时丢帧，等显示端释放旧帧
+    qint64 cost = m_framePool.acquireCost(outSize.width(), outSize.height(), m_imageFormat);
+    if (cost > 0 && m_budget && !m_budget->withinLimit(MemoryBudget::BudgetFramePool, cost))
+    {
+        m_budget->countOverrun(MemoryBudget::BudgetFramePool);
+        av_frame_unref(decoded);
+        return false;
+    }
+
+    // 可见区域做成引用解码缓冲区的裁剪视图，不拷贝像素
+    const AVFrame* source = decoded;
+    if (cropped && av_frame_ref(worker->cropFrame, decoded) >= 0)
+    {
+        worker->cropFrame->crop_left = crop.x();
+        worker->cropFrame->crop_top = crop.y();
+        worker->cropFrame->crop_right = sourceSize.width() - crop.x() - crop.width();
+        worker->cropFrame->crop_bottom = sourceSize.height() - crop.y() - crop.height();
+        if (av_frame_apply_cropping(worker->cropFrame, AV_FRAME_CROP_UNALIGNED) >= 0)
+        {
+            source = worker->cropFrame;
+        }
+    }
+
+    QImage image;
+    if (cropped && source == decoded)
+    {
+        LogWidget::instance()->addLog(QString("Could not crop MJPEG frame to the visible rect"), LogWidget::Warning);
+    }
+    else
+    {
+        image = m_framePool.acquire(outSize.width(), outSize.height(), m_imageFormat);
+    }
+    if (!image.isNull())
+    {
+        // 全范围 YUVJ 等专用内核不支持的格式，以及需要缩放时走 sws_scale
+        if (outSize == QSize(source->width, source->height) && YuvConverter::supports(source, m_swsFormat))
+        {
+            worker->yuvConverter.convert(source, m_swsFormat, image.bits(), image.bytesPerLine(),
+                                         0, source->height);
+        }
+        else
+        {
+            worker->swsCtx = sws_getCachedContext(worker->swsCtx,
+                                                  source->width, source->height,
+                                                  static_cast<AVPixelFormat>(source->format),
+                                                  image.width(), image.height(), m_swsFormat,
+                                                  SWS_BILINEAR, nullptr, nullptr, nullptr);
+            if (worker->swsCtx)
+            {
+                uint8_t* destData[4] = { image.bits(), nullptr, nullptr, nullptr };
+                int destLinesize[4] = { static_cast<int>(image.bytesPerLine()), 0, 0, 0 };
+                sws_scale(worker->swsCtx, source->data, source->linesize, 0, source->height,
+                          destData, destLinesize);
+            }
+            else
+            {
+                image = QImage();
+            }
+        }
+    }
+    av_frame_unref(worker->cropFrame);
+    av_frame_unref(decoded);
+
+    if (!image.isNull())
+    {
+        frame.image = image;
+        frame.sourceSize = sourceSize;
+        frame.visibleRect = deskNormalizedRect(crop, sourceSize);
+        frame.receivedNs = job.receivedNs;
+        frame.decodedNs = StreamStats::nowNs();
+    }
+    return true;
+}
+
+void MjpegDecodePool::complete(quint64 seq, const VideoFrame& frame)
+{
+    QMutexLocker locker(&m_reorderMutex);
+    if (seq != m_nextPublish)
+    {
+        // 前面还有帧在解码，先放进排序缓冲
+        m_done.insert(seq, frame);
+        if (!frame.image.isNull())
+        {
+            m_reordered.fetch_add(1, std::memory_order_relaxed);
+        }
+        return;
+    }
+
+    if (!frame.image.isNull())
+    {
+        m_publish(frame);
+    }
+    ++m_nextPublish;
+
+    // 依次发布之后已经就绪的帧
+    auto it = m_done.begin();
+    while (it != m_done.end() && it.key() == m_nextPublish)
+    {
+        if (!it.value().image.isNull())
+        {
+            m_publish(it.value());
+        }
+        it = m_done.erase(it);
+        ++m_nextPublish;
+    }
+    m_idleCond.wakeAll();
+}
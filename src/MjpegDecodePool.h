@@ -0,0 +1,111 @@
+#ifndef MJPEGDECODEPOOL_H
+#define MJPEGDECODEPOOL_H
+
+#include <QByteArray>
+#include <QImage>
+#include <QMap>
+#include <QMutex>
+#include <QQueue>
+#include <QRectF>
+#include <QSize>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+#include "FrameMailbox.h"
+#include "FramePool.h"
+#include "MemoryBudget.h"
+
+// MJPEG 并行解码线程池
+// 每个 JPEG 帧都能独立解码，不像 H.264 那样受参考链约束，可以分给多个核心同时解码。
+// 每个线程持有自己的 mjpeg 解码器和 SwsContext，解码并转换（缩放）后按到达序号重新排序，
+// 严格按顺序交给 publish 回调；回调在持有排序锁时调用，同一时刻只有一个线程在发布。
+class MjpegDecodePool
+{
+public:
+    typedef std::function<void(const VideoFrame&)> PublishFunc;
+
+    // maxPending 为排队等待解码的帧数上限，超出时丢弃最旧的未开始帧
+    // swsFormat 为 imageFormat 对应的 swscale 目标格式
+    // budget 不为空时，输出帧需要新分配缓冲区且超出帧缓冲预算则丢弃该帧
+    MjpegDecodePool(int threadCount, int maxPending, QImage::Format imageFormat, AVPixelFormat swsFormat,
+                    const PublishFunc& publish, const std::shared_ptr<MemoryBudget>& budget = nullptr);
+    ~MjpegDecodePool();
+
+    // 解码线程调用，按调用顺序分配序号；targetSize 为空时按源分辨率输出
+    // visibleRect 为放大时的可见区域（归一化），与 H.264 路径一样只转换这一块
+    void submit(const QByteArray& data, qint64 receivedNs, const QSize& targetSize, const QRectF& visibleRect);
+
+    // 丢弃尚未开始的帧（码流切换、会话结束时）
+    void clear();
+    // 等待已提交的帧全部发布（或丢弃），与 submit() 在同一线程调用
+    void waitIdle();
+
+    int threadCount() const { return m_threads.size(); }
+    quint64 decodedCount() const { return m_decoded.load(std::memory_order_relaxed); }
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+    quint64 failedCount() const { return m_failed.load(std::memory_order_relaxed); }
+    // 先于前面的帧完成、在排序缓冲里等待过的帧数
+    quint64 reorderedCount() const { return m_reordered.load(std::memory_order_relaxed); }
+    // 单帧平均解码 + 转换耗时
+    qint64 averageDecodeNs() const;
+    const FramePool& framePool() const { return m_framePool; }
+
+    MjpegDecodePool(const MjpegDecodePool&) = delete;
+    MjpegDecodePool& operator=(const MjpegDecodePool&) = delete;
+
+private:
+    struct Job
+    {
+        quint64 seq = 0;
+        QByteArray data;
+        qint64 receivedNs = 0;
+        QSize targetSize;
+        QRectF visibleRect;
+    };
+
+    void workerLoop(int index);
+    // 在工作线程的解码器上解码一帧；失败时 frame.image 为空，因内存预算丢弃时返回 false
+    bool decodeJob(int index, const Job& job, VideoFrame& frame);
+    // 记录 seq 的结果，并按序发布所有已就绪的帧；image 为空表示该序号被丢弃或解码失败
+    void complete(quint64 seq, const VideoFrame& frame);
+
+    struct Worker;
+    QVector<QThread*> m_threads;
+    QVector<Worker*> m_workers;
+
+    QMutex m_mutex;
+    QWaitCondition m_jobCond;
+    QQueue<Job> m_jobs;
+    int m_maxPending = 0;
+    quint64 m_nextSeq = 0;
+    bool m_quit = false;
+
+    // 排序缓冲: 已完成但前面还有未完成帧的结果
+    QMutex m_reorderMutex;
+    QMap<quint64, VideoFrame> m_done;
+    quint64 m_nextPublish = 0;
+    QWaitCondition m_idleCond;
+
+    QImage::Format m_imageFormat;
+    AVPixelFormat m_swsFormat;
+    PublishFunc m_publish;
+    std::shared_ptr<MemoryBudget> m_budget;
+    // 在途帧: 每个线程正在写入的 1 帧 + 排序缓冲 + 邮箱三缓冲
+    FramePool m_framePool;
+
+    std::atomic<quint64> m_decoded{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_failed{0};
+    std::atomic<quint64> m_reordered{0};
+    std::atomic<qint64> m_decodeNs{0};
+};
+
+#endif // MJPEGDECODEPOOL_H
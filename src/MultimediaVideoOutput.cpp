@@ -0,0 +1,193 @@
+#include "MultimediaVideoOutput.h"
+#include "DeskDefine.h"
+#include "LogWidget.h"
+
+#include <QAbstractVideoSurface>
+#include <QMediaObject>
+#include <QMediaService>
+#include <QVideoRendererControl>
+#include <QVideoSurfaceFormat>
+
+extern "C" {
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+}
+
+// QVideoWidget 绑定媒体对象后，从服务里请求渲染控制接口并把自己的 surface 交给它
+class MediaRendererControl : public QVideoRendererControl
+{
+public:
+    explicit MediaRendererControl(QObject* parent)
+        : QVideoRendererControl(parent)
+    {
+    }
+
+    QAbstractVideoSurface* surface() const override { return m_surface; }
+    void setSurface(QAbstractVideoSurface* surface) override
+    {
+        if (m_surface && m_surface->isActive())
+        {
+            m_surface->stop();
+        }
+        m_surface = surface;
+    }
+
+private:
+    QAbstractVideoSurface* m_surface = nullptr;
+};
+
+class MediaRendererService : public QMediaService
+{
+public:
+    explicit MediaRendererService(QObject* parent)
+        : QMediaService(parent)
+        , m_control(new MediaRendererControl(this))
+    {
+    }
+
+    QMediaControl* requestControl(const char* name) override
+    {
+        return qstrcmp(name, QVideoRendererControl_iid) == 0 ? m_control : nullptr;
+    }
+    void releaseControl(QMediaControl* control) override { Q_UNUSED(control); }
+
+    MediaRendererControl* control() const { return m_control; }
+
+private:
+    MediaRendererControl* m_control;
+};
+
+class MediaRendererSource : public QMediaObject
+{
+public:
+    MediaRendererSource(QObject* parent, QMediaService* service)
+        : QMediaObject(parent, service)
+    {
+    }
+};
+
+AVFrameVideoBuffer::AVFrameVideoBuffer(const std::shared_ptr<AVFrame>& frame)
+    : QAbstractPlanarVideoBuffer(NoHandle)
+    , m_frame(frame)
+{
+}
+
+int AVFrameVideoBuffer::map(MapMode mode, int* numBytes, int bytesPerLine[4], uchar* data[4])
+{
+    if (m_mapMode != NotMapped || (mode & WriteOnly))
+    {
+        return 0;
+    }
+
+    int planes = m_frame->format == AV_PIX_FMT_NV12 ? 2 : 3;
+    int chromaHeight = (m_frame->height + 1) / 2;
+    int bytes = 0;
+    for (int i = 0; i < planes; ++i)
+    {
+        bytesPerLine[i] = m_frame->linesize[i];
+        data[i] = m_frame->data[i];
+        bytes += m_frame->linesize[i] * (i == 0 ? m_frame->height : chromaHeight);
+    }
+    if (numBytes)
+    {
+        *numBytes = bytes;
+    }
+    m_mapMode = mode;
+    return planes;
+}
+
+void AVFrameVideoBuffer::unmap()
+{
+    m_mapMode = NotMapped;
+}
+
+MultimediaVideoOutput::MultimediaVideoOutput(QVideoWidget* view, QObject* parent)
+    : QObject(parent)
+    , m_view(view)
+{
+    m_service = new MediaRendererService(this);
+    m_control = m_service->control();
+    m_source = new MediaRendererSource(this, m_service);
+    // 画面已经按 letterbox 区域摆放，不再让 QVideoWidget 保持比例
+    m_view->setAspectRatioMode(Qt::IgnoreAspectRatio);
+    m_source->bind(m_view);
+}
+
+MultimediaVideoOutput::~MultimediaVideoOutput()
+{
+    if (m_control->surface() && m_control->surface()->isActive())
+    {
+        m_control->surface()->stop();
+    }
+    m_source->unbind(m_view);
+}
+
+void MultimediaVideoOutput::setVisibleRect(const QRectF& rect)
+{
+    m_visibleRect = rect;
+    if (m_lastFrame.yuv)
+    {
+        present(m_lastFrame);
+    }
+}
+
+bool MultimediaVideoOutput::present(const VideoFrame& frame)
+{
+    QAbstractVideoSurface* surface = m_control->surface();
+    if (!surface)
+    {
+        return false;
+    }
+
+    m_lastFrame = frame;
+
+    // 放大时交给 surface 的是只引用可见区域的裁剪视图，不拷贝像素
+    std::shared_ptr<AVFrame> planes = frame.yuv;
+    QSize frameSize(planes->width, planes->height);
+    QRect crop = deskVisibleSourceRect(m_visibleRect, frameSize);
+    if (crop.size() != frameSize)
+    {
+        AVFrame* view = av_frame_clone(planes.get());
+        if (view)
+        {
+            view->crop_left = crop.x();
+            view->crop_top = crop.y();
+            view->crop_right = frameSize.width() - crop.x() - crop.width();
+            view->crop_bottom = frameSize.height() - crop.y() - crop.height();
+            if (av_frame_apply_cropping(view, AV_FRAME_CROP_UNALIGNED) < 0)
+            {
+                av_frame_free(&view);
+            }
+        }
+        if (view)
+        {
+            planes.reset(view, [](AVFrame* f) { av_frame_free(&f); });
+        }
+    }
+
+    const AVFrame* yuv = planes.get();
+    QVideoFrame::PixelFormat pixelFormat = yuv->format == AV_PIX_FMT_NV12 ? QVideoFrame::Format_NV12
+                                                                          : QVideoFrame::Format_YUV420P;
+    QSize size(yuv->width, yuv->height);
+    QVideoSurfaceFormat current = surface->surfaceFormat();
+    if (!surface->isActive() || current.frameSize() != size || current.pixelFormat() != pixelFormat)
+    {
+        if (surface->isActive())
+        {
+            surface->stop();
+        }
+        QVideoSurfaceFormat format(size, pixelFormat);
+        bool fullRange = yuv->format == AV_PIX_FMT_YUVJ420P || yuv->color_range == AVCOL_RANGE_JPEG;
+        format.setYCbCrColorSpace(fullRange ? QVideoSurfaceFormat::YCbCr_JPEG : QVideoSurfaceFormat::YCbCr_BT601);
+        if (!surface->start(format))
+        {
+            LogWidget::instance()->addLog(QString("[MultimediaVideoOutput] surface rejected %1x%2 format %3: %4")
+                                              .arg(size.width()).arg(size.height()).arg(pixelFormat)
+                                              .arg(surface->error()), LogWidget::Warning);
+            return false;
+        }
+    }
+
+    QVideoFrame videoFrame(new AVFrameVideoBuffer(planes), size, pixelFormat);
+    return surface->present(videoFrame);
+}
@@ -0,0 +1,56 @@
+#ifndef MULTIMEDIAVIDEOOUTPUT_H
+#define MULTIMEDIAVIDEOOUTPUT_H
+
+#include <QAbstractPlanarVideoBuffer>
+#include <QObject>
+#include <QVideoWidget>
+#include <memory>
+
+#include "FrameMailbox.h"
+
+class MediaRendererControl;
+class MediaRendererService;
+class MediaRendererSource;
+
+// 不拷贝像素的 QVideoFrame 缓冲区，直接引用解码输出 AVFrame 的 YUV 平面
+// 解码器的帧缓冲区按引用计数共享，只允许只读映射
+class AVFrameVideoBuffer : public QAbstractPlanarVideoBuffer
+{
+public:
+    explicit AVFrameVideoBuffer(const std::shared_ptr<AVFrame>& frame);
+
+    MapMode mapMode() const override { return m_mapMode; }
+    int map(MapMode mode, int* numBytes, int bytesPerLine[4], uchar* data[4]) override;
+    void unmap() override;
+
+private:
+    std::shared_ptr<AVFrame> m_frame;
+    MapMode m_mapMode = NotMapped;
+};
+
+// 通过 Qt Multimedia 显示解码输出
+// 用一个只提供 QVideoRendererControl 的媒体服务绑定到 QVideoWidget，拿到它内部的视频 surface，
+// 把 YUV420P/NV12 帧包装成 QVideoFrame 直接 present，色彩转换和缩放走 Qt 的平台渲染路径。
+class MultimediaVideoOutput : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit MultimediaVideoOutput(QVideoWidget* view, QObject* parent = nullptr);
+    ~MultimediaVideoOutput();
+
+    // frame.yuv 不能为空。surface 不支持该格式时返回 false，调用方应回退到 RGB 输出
+    bool present(const VideoFrame& frame);
+    // 放大时只显示源画面的这一块（归一化坐标），用最近一帧立即重新 present
+    void setVisibleRect(const QRectF& rect);
+
+private:
+    QVideoWidget* m_view = nullptr;
+    MediaRendererControl* m_control = nullptr;
+    MediaRendererService* m_service = nullptr;
+    MediaRendererSource* m_source = nullptr;
+    QRectF m_visibleRect = QRectF(0, 0, 1, 1);
+    VideoFrame m_lastFrame;
+};
+
+#endif // MULTIMEDIAVIDEOOUTPUT_H
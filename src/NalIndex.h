@@ -0,0 +1,50 @@
+#ifndef NALINDEX_H
+#define NALINDEX_H
+
+#include <QByteArray>
+#include <QVector>
+
+#include "DeskDefine.h"
+
+// 与编码格式无关的码流结构描述，H.264/HEVC 为 NAL 单元，MJPEG 每包一帧
+// 各格式的解析见 H264Nal 和 StreamParser
+
+// NAL 索引中的一项
+struct NalUnit
+{
+    int offset = 0;   // NAL 头字节在包内的位置（起始码之后）
+    int size = 0;     // NAL 长度（含头字节，不含下一个起始码及其前导 0）
+    int type = 0;     // 按各自编码格式的类型编号
+    int refIdc = 0;   // H.264 nal_ref_idc，其它格式为 0
+};
+
+// 每个包只扫描一次起始码，拆帧、关键帧判断、丢包策略和统计都复用这份索引
+typedef QVector<NalUnit> NalIndex;
+
+// 一个访问单元（或逐片模式下的一个片）及其 NAL 索引
+struct AccessUnit
+{
+    QByteArray data;
+    NalIndex nals;
+    DeskVideoCodec codec = VIDEO_CODEC_H264;
+};
+
+// 一个数据包的结构概要
+struct PacketInfo
+{
+    bool hasIdr = false;         // 含 IDR 片（HEVC 为 IRAP，MJPEG 每帧都是）
+    bool hasSps = false;         // 含参数集（H.264 SPS，HEVC VPS/SPS）
+    bool hasVcl = false;         // 含图像数据（片）
+    bool isReference = false;    // 任一片的 nal_ref_idc != 0，丢弃后会影响后续帧
+    bool startsPicture = false;  // 第一个片是图像的首片（first_mb_in_slice == 0）
+    bool hasRecoveryPoint = false; // 含恢复点 SEI（帧内刷新码流的随机接入点）
+    int recoveryFrameCnt = 0;    // 恢复点之后还需多少帧画面才完整
+};
+
+// 概要中是否含可以开始解码的随机接入点(IDR/IRAP首片、参数集或恢复点SEI)
+inline bool isRandomAccessPoint(const PacketInfo& info)
+{
+    return (info.hasIdr && info.startsPicture) || info.hasSps || (info.hasRecoveryPoint && info.hasVcl);
+}
+
+#endif // NALINDEX_H
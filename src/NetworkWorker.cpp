@@ -10,9 +10,21 @@
 #include "LogWidget.h"
 #include "DeskDefine.h"
 
+// 包队列占用超过其额度的这个百分比时暂停读取 socket，留出余量给正在拆的包
+#define RECEIVE_PAUSE_PERCENT 75
+
+// 暂停读取期间检查包队列是否已被解码线程消费的间隔
+#define RECEIVE_RESUME_POLL_MS 5
+
 NetworkWorker::NetworkWorker(QObject* parent)
     : QObject(parent)
 {
+    // 单次触发，暂停读取时启动；定时器随 NetworkWorker 移到网络线程
+    m_resumeTimer = new QTimer(this);
+    m_resumeTimer->setSingleShot(true);
+    m_resumeTimer->setInterval(RECEIVE_RESUME_POLL_MS);
+    connect(m_resumeTimer, &QTimer::timeout, this, &NetworkWorker::onSocketReadyRead);
+
     connect(&messageHandler, &MessageHandler::InpuVideoFrameReceived,
             this, &NetworkWorker::packetReady);
 
@@ -25,6 +37,11 @@ NetworkWorker::~NetworkWorker()
     cleanup();
 }
 
+void NetworkWorker::setMemoryBudget(const std::shared_ptr<MemoryBudget>& budget)
+{
+    m_budget = budget;
+}
+
 void NetworkWorker::cleanup()
 {
     if (m_socket)
@@ -38,7 +55,11 @@ void NetworkWorker::cleanup()
         m_socket = nullptr;
     }
 
+    m_resumeTimer->stop();
+    m_receivePaused = false;
     m_buffer.clear();
+    m_skipBytes = 0;
+    updateReceiveUsage();
 }
 
 void NetworkWorker::connectToServer(const QString& ip, quint16 port, const QString& uuid)
@@ -93,6 +114,12 @@ void NetworkWorker::connectToServer(const QString& ip, quint16 port, const QStri
         m_socket = nullptr;
     }
     m_socket = new QTcpSocket(this);
+    if (m_budget)
+    {
+        // 限制 Qt 的读缓冲: onSocketReadyRead 暂停读取后，缓冲满了 Qt 即停止从内核读取，
+        // TCP 窗口收紧后由服务端放慢发送。另一半留给拆包缓冲 m_buffer
+        m_socket->setReadBufferSize(m_budget->limit(MemoryBudget::BudgetReceiveBuffer) / 2);
+    }
 
     connect(m_socket, &QTcpSocket::connected, this, &NetworkWorker::onSocketConnected);
     connect(m_socket, &QTcpSocket::readyRead, this, &NetworkWorker::onSocketReadyRead);
@@ -150,16 +177,38 @@ void NetworkWorker::sendRequestRelay()
 
 void NetworkWorker::onSocketReadyRead()
 {
-    LogWidget::instance()->addLog("[NetworkWorker] onSocketReadyRead CALLED!", LogWidget::Info);
-
-    //m_buffer.append(m_socket->readAll());
-    QByteArray newData = m_socket->readAll();
-    m_buffer.append(newData);
-
-    LogWidget::instance()->addLog(QString("[NetworkWorker] received bytes: %1, buffer total: %2")
-                                      .arg(newData.size()).arg(m_buffer.size()), LogWidget::Info);
+    // 不再一次 readAll: 每次最多读到拆包缓冲的额度，包队列积压时停止读取，
+    // 数据留在 Qt 读缓冲和内核里，TCP 流控由此生效；队列消费下去后由 m_resumeTimer 重新进入
+    while (m_socket && m_socket->bytesAvailable() > 0)
+    {
+        if (receiveThrottled())
+        {
+            if (!m_receivePaused)
+            {
+                m_receivePaused = true;
+                m_budget->countOverrun(MemoryBudget::BudgetReceiveBuffer);
+            }
+            m_resumeTimer->start();
+            break;
+        }
+        m_receivePaused = false;
 
+        //m_buffer.append(m_socket->readAll());
+        QByteArray newData = m_socket->read(receiveChunkSize());
+        if (m_skipBytes > 0)
+        {
+            int skipped = static_cast<int>(qMin<qint64>(m_skipBytes, newData.size()));
+            newData.remove(0, skipped);
+            m_skipBytes -= skipped;
+        }
+        m_buffer.append(newData);
+        processBuffer();
+    }
+    updateReceiveUsage();
+}
 
+void NetworkWorker::processBuffer()
+{
     // 协议： [4字节大端序包长] + [包数据]
     while (m_buffer.size() >= 4)
     {
@@ -167,6 +216,26 @@ void NetworkWorker::onSocketReadyRead()
         memcpy(&packetSize, m_buffer.constData(), 4);
         packetSize = qFromBigEndian(packetSize);
 
+        // 单个包超出接收预算时整包跳过，避免 m_buffer 为等齐它无限增长。
+        // 跳过的可能是一帧视频，之后的帧参考链已断，通知接收端等待下一个关键帧
+        qint64 totalSize = 4 + qint64(packetSize);
+        if (m_budget && totalSize > m_budget->limit(MemoryBudget::BudgetReceiveBuffer) / 2)
+        {
+            m_budget->countOverrun(MemoryBudget::BudgetReceiveBuffer);
+            if (!m_oversizeLogged)
+            {
+                m_oversizeLogged = true;
+                LogWidget::instance()->addLog(QString("[NetworkWorker] packet of %1 bytes exceeds receive budget, skipped; "
+                                                      "waiting for the next key frame (further skips are not logged)")
+                                                  .arg(packetSize), LogWidget::Warning);
+            }
+            int dropped = static_cast<int>(qMin<qint64>(totalSize, m_buffer.size()));
+            m_buffer.remove(0, dropped);
+            m_skipBytes = totalSize - dropped;
+            emit streamDiscontinuity();
+            continue;
+        }
+
         if (m_buffer.size() < 4 + (int)packetSize)
         {
             break;
@@ -179,6 +248,53 @@ void NetworkWorker::onSocketReadyRead()
     }
 }
 
+bool NetworkWorker::receiveThrottled() const
+{
+    if (!m_budget)
+    {
+        return false;
+    }
+    // 包队列由解码线程消费，积压说明解码跟不上。不看会话总额度: 帧缓冲由显示端释放，与读取无关
+    qint64 queueLimit = m_budget->limit(MemoryBudget::BudgetPacketQueue);
+    return m_budget->usage(MemoryBudget::BudgetPacketQueue) * 100 > queueLimit * RECEIVE_PAUSE_PERCENT;
+}
+
+qint64 NetworkWorker::receiveChunkSize() const
+{
+    if (!m_budget)
+    {
+        return m_socket->bytesAvailable();
+    }
+    // 拆包缓冲最多存一个额度内的包（更大的包会被跳过），读满额度即可拆出至少一个包
+    return qMax<qint64>(4, m_budget->limit(MemoryBudget::BudgetReceiveBuffer) / 2 - m_buffer.size());
+}
+
+void NetworkWorker::updateReceiveUsage()
+{
+    if (!m_budget)
+    {
+        return;
+    }
+    qint64 pending = m_socket ? m_socket->bytesAvailable() : 0;
+    m_budget->setUsage(MemoryBudget::BudgetReceiveBuffer, m_buffer.size() + pending);
+    m_budget->setUsage(MemoryBudget::BudgetSendQueue, m_socket ? m_socket->bytesToWrite() : 0);
+}
+
+bool NetworkWorker::sendQueueAvailable(qint64 bytes)
+{
+    if (!m_budget || !m_socket)
+    {
+        return true;
+    }
+    m_budget->setUsage(MemoryBudget::BudgetSendQueue, m_socket->bytesToWrite());
+    if (m_budget->withinLimit(MemoryBudget::BudgetSendQueue, bytes))
+    {
+        return true;
+    }
+    m_budget->countOverrun(MemoryBudget::BudgetSendQueue);
+    return false;
+}
+
 void NetworkWorker::sendMouseEventToServer(int x, int y, int mask, int value)
 {
     MouseEvent mouseEvent;
@@ -211,6 +327,12 @@ void NetworkWorker::sendMouseEventToServer(int x, int y, int mask, int value)
     sendData.append(reinterpret_cast<const char*>(&len_be), sizeof(len_be));
     sendData.append(protobufData);
 
+    // 发送积压时丢弃移动事件，后续的移动会带上最新位置；按键类事件始终发送
+    if (mask == MouseMove && !sendQueueAvailable(sendData.size()))
+    {
+        return;
+    }
+
     if (m_socket && m_socket->state() == QAbstractSocket::ConnectedState)
     {
         m_socket->write(sendData);
@@ -233,8 +355,10 @@ void NetworkWorker::sendTouchEventToServer(QVariant value)
     touchEvent.set_timestamp(deskTouchEvent.timestamp);
 
     QList<DeskTouchPoint> points = deskTouchEvent.points;
+    bool moveOnly = true;
     for (const auto &pt : points)
     {
+        moveOnly &= pt.phase == TOUCH_MOVE;
         auto *point = touchEvent.add_points();
         point->set_id(pt.id);
         point->set_x(pt.x);
@@ -268,6 +392,12 @@ void NetworkWorker::sendTouchEventToServer(QVariant value)
     sendData.append(reinterpret_cast<const char*>(&len_be), sizeof(len_be));
     sendData.append(protobufData);
 
+    // 只含移动触点的事件可以丢弃，按下/抬起必须送达，否则服务端的触点状态会错乱
+    if (moveOnly && !sendQueueAvailable(sendData.size()))
+    {
+        return;
+    }
+
     if (m_socket && m_socket->state() == QAbstractSocket::ConnectedState)
     {
         m_socket->write(sendData);
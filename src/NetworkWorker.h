@@ -4,7 +4,10 @@
 #include <QObject>
 #include <QtNetwork/QTcpSocket>
 #include <QByteArray>
+#include <QTimer>
+#include <memory>
 #include "MessageHandler.h"
+#include "MemoryBudget.h"
 
 class NetworkWorker : public QObject
 {
@@ -13,6 +16,9 @@ public:
     explicit NetworkWorker(QObject* parent = nullptr);
     ~NetworkWorker();
 
+    // 在 connectToServer 之前设置，限制接收缓冲和发送队列
+    void setMemoryBudget(const std::shared_ptr<MemoryBudget>& budget);
+
 public slots:
     // 在工作线程里调用，连接到指定服务器并发送请求
     void connectToServer(const QString& host, quint16 port, const QString& uuid);
@@ -25,6 +31,8 @@ public slots:
 signals:
     // 当拆包出一帧 H264 数据后，发出信号给解码线程
     void packetReady(const QByteArray& packetData);
+    // 超出接收预算的包被整包跳过，码流不再连续，接收端应丢弃半帧并等待关键帧
+    void streamDiscontinuity();
     // 网络出错、断开等信号，可以通知主线程
     void networkError(const QString& error);
     void connectedToServer();
@@ -38,6 +46,15 @@ private slots:
 
 private:
     void sendRequestRelay();
+    // 发送队列超出预算时返回 false 并计数，只用于可合并的移动类事件
+    bool sendQueueAvailable(qint64 bytes);
+    void updateReceiveUsage();
+    // 从 m_buffer 拆出完整的包交给 messageHandler
+    void processBuffer();
+    // 包队列积压，应暂停读取 socket
+    bool receiveThrottled() const;
+    // 本次从 socket 读取的最大字节数
+    qint64 receiveChunkSize() const;
 
 private:
     QTcpSocket* m_socket = nullptr;
@@ -45,6 +62,14 @@ private:
     QString m_uuid;
     QString m_host;
     quint16 m_port;
+    std::shared_ptr<MemoryBudget> m_budget;
+    // 超出接收预算的包剩余待跳过的字节数
+    qint64 m_skipBytes = 0;
+    // 跳包只在第一次记日志
+    bool m_oversizeLogged = false;
+    // 积压时暂停读取，定时检查包队列是否已消费
+    QTimer* m_resumeTimer = nullptr;
+    bool m_receivePaused = false;
     MessageHandler messageHandler;
 };
 
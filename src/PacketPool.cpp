@@ -0,0 +1,68 @@
+#include "PacketPool.h"
+
+#include <cstring>
+
+// 高水位按 64KB 取整，并额外预留 1/4，避免码率小幅波动时反复重建
+static const int POOL_SIZE_ALIGN = 64 * 1024;
+
+PacketPool::PacketPool()
+{
+}
+
+PacketPool::~PacketPool()
+{
+    reset();
+}
+
+void PacketPool::reset()
+{
+    // 仍被解码器引用的缓冲区在最后一个引用释放后才真正回收
+    av_buffer_pool_uninit(&m_pool);
+    m_bufferSize = 0;
+}
+
+bool PacketPool::ensureCapacity(int size)
+{
+    int required = size + AV_INPUT_BUFFER_PADDING_SIZE;
+    if (m_pool && required <= m_bufferSize)
+    {
+        return true;
+    }
+
+    int newSize = required + required / 4;
+    newSize = (newSize + POOL_SIZE_ALIGN - 1) / POOL_SIZE_ALIGN * POOL_SIZE_ALIGN;
+
+    av_buffer_pool_uninit(&m_pool);
+    m_pool = av_buffer_pool_init(newSize, nullptr);
+    if (!m_pool)
+    {
+        m_bufferSize = 0;
+        return false;
+    }
+    m_bufferSize = newSize;
+    ++m_regrowCount;
+    return true;
+}
+
+bool PacketPool::fill(AVPacket* pkt, const uint8_t* data, int size)
+{
+    if (!pkt || size <= 0 || !ensureCapacity(size))
+    {
+        return false;
+    }
+
+    AVBufferRef* buf = av_buffer_pool_get(m_pool);
+    if (!buf)
+    {
+        return false;
+    }
+
+    memcpy(buf->data, data, size);
+    // 复用的缓冲区填充区可能残留旧数据，解码器要求其为 0
+    memset(buf->data + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+
+    pkt->buf = buf;
+    pkt->data = buf->data;
+    pkt->size = size;
+    return true;
+}
@@ -0,0 +1,39 @@
+#ifndef PACKETPOOL_H
+#define PACKETPOOL_H
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+}
+
+// 解码输入包的缓冲池
+// 缓冲区带 AV_INPUT_BUFFER_PADDING_SIZE 填充且引用计数，按码流出现过的最大包长（高水位）分配，
+// 稳态下 fill() 只做一次 memcpy，不再分配内存
+class PacketPool
+{
+public:
+    PacketPool();
+    ~PacketPool();
+
+    // 把 data 拷贝进池化缓冲区并挂到 pkt 上（pkt 须已 unref）
+    // 解码器释放引用后缓冲区自动回到池中
+    bool fill(AVPacket* pkt, const uint8_t* data, int size);
+
+    void reset();
+
+    int bufferSize() const { return m_bufferSize; }
+    // 因高水位上涨而重建池的次数
+    int regrowCount() const { return m_regrowCount; }
+
+    PacketPool(const PacketPool&) = delete;
+    PacketPool& operator=(const PacketPool&) = delete;
+
+private:
+    bool ensureCapacity(int size);
+
+    AVBufferPool* m_pool = nullptr;
+    int m_bufferSize = 0;   // 单个缓冲区容量（含填充）
+    int m_regrowCount = 0;
+};
+
+#endif // PACKETPOOL_H
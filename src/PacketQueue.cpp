@@ -0,0 +1,171 @@
+#include "PacketQueue.h"
+#include "StreamStats.h"
+#include "StreamParser.h"
+
+#include <QtGlobal>
+
+PacketQueue::PacketQueue(int maxPackets, int latencyBudgetMs, const std::shared_ptr<MemoryBudget>& budget)
+    : m_maxPackets(qMax(2, maxPackets))
+    , m_latencyBudgetNs(qint64(qMax(1, latencyBudgetMs)) * 1000000)
+    , m_budget(budget)
+{
+}
+
+bool PacketQueue::push(const AccessUnit& unit)
+{
+    Entry entry;
+    entry.data = unit.data;
+    entry.nals = unit.nals;
+    entry.codec = unit.codec;
+    entry.receivedNs = StreamStats::nowNs();
+    // NAL 索引已在网络线程建好，这里只汇总，解码线程出队时直接使用
+    entry.info = summarizeStreamUnits(unit.codec, reinterpret_cast<const uint8_t*>(unit.data.constData()), unit.nals);
+
+    QMutexLocker locker(&m_mutex);
+
+    if (m_waitKeyFrame) {
+        if (!isRandomAccessPoint(entry.info)) {
+            ++m_dropped;
+            return false;
+        }
+        m_waitKeyFrame = false;
+    }
+
+    bool wasEmpty = m_queue.isEmpty();
+    m_queue.enqueue(entry);
+    m_bytes += entry.data.size();
+    trim(entry.receivedNs);
+    if (m_budget) {
+        m_budget->setUsage(MemoryBudget::BudgetPacketQueue, m_bytes);
+    }
+    return wasEmpty;
+}
+
+bool PacketQueue::pop(Entry& entry)
+{
+    QMutexLocker locker(&m_mutex);
+    if (m_queue.isEmpty()) {
+        return false;
+    }
+    entry = m_queue.dequeue();
+    m_bytes -= entry.data.size();
+    if (m_budget) {
+        m_budget->setUsage(MemoryBudget::BudgetPacketQueue, m_bytes);
+    }
+    entry.discontinuity = m_discontinuity;
+    m_discontinuity = false;
+    return true;
+}
+
+void PacketQueue::reset()
+{
+    QMutexLocker locker(&m_mutex);
+    m_dropped += m_queue.size();
+    m_queue.clear();
+    m_bytes = 0;
+    if (m_budget) {
+        m_budget->setUsage(MemoryBudget::BudgetPacketQueue, m_bytes);
+    }
+    m_waitKeyFrame = true;
+    m_discontinuity = true;
+}
+
+int PacketQueue::depth() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_queue.size();
+}
+
+qint64 PacketQueue::bytes() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_bytes;
+}
+
+bool PacketQueue::overMemory() const
+{
+    // 至少保留一个包，单个超大关键帧也要能送到解码器
+    return m_budget && m_queue.size() > 1
+        && m_bytes > m_budget->limit(MemoryBudget::BudgetPacketQueue);
+}
+
+quint64 PacketQueue::droppedCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_dropped;
+}
+
+quint64 PacketQueue::idrSkipCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_idrSkips;
+}
+
+bool PacketQueue::overBudget(qint64 nowNs) const
+{
+    return m_queue.size() > m_maxPackets || overMemory()
+        || (m_queue.size() > 1 && nowNs - m_queue.head().receivedNs > m_latencyBudgetNs);
+}
+
+void PacketQueue::trim(qint64 nowNs)
+{
+    if (!overBudget(nowNs)) {
+        return;
+    }
+    if (overMemory()) {
+        m_budget->countOverrun(MemoryBudget::BudgetPacketQueue);
+    }
+
+    // 1. 跳到最新的 IDR 或恢复点，之前的内容解出来也已过期
+    // 逐片送入时只能跳到 IDR 的首片；恢复点 SEI 与所属画面的首片在同一个单元
+    int keyIndex = -1;
+    for (int i = m_queue.size() - 1; i > 0; --i) {
+        const PacketInfo& info = m_queue.at(i).info;
+        if ((info.hasIdr || info.hasRecoveryPoint) && info.startsPicture) {
+            keyIndex = i;
+            break;
+        }
+    }
+    if (keyIndex > 0) {
+        bool toIdr = m_queue.at(keyIndex).info.hasIdr;
+        // 紧挨在 IDR 前面、单独成包的 SPS/PPS/SEI 要一起保留
+        while (keyIndex > 0 && !m_queue.at(keyIndex - 1).info.hasVcl) {
+            --keyIndex;
+        }
+        if (keyIndex > 0) {
+            m_dropped += keyIndex;
+            for (int i = 0; i < keyIndex; ++i) {
+                m_bytes -= m_queue.at(i).data.size();
+            }
+            m_queue.erase(m_queue.begin(), m_queue.begin() + keyIndex);
+            ++m_idrSkips;
+            // 跳到恢复点时之前的参考帧已丢失，解码器要清空参考帧并重新隐藏刷新期间的画面
+            if (!toIdr) {
+                m_discontinuity = true;
+            }
+        }
+        if (!overBudget(nowNs)) {
+            return;
+        }
+    }
+
+    // 2. 丢弃非参考帧，不影响其它帧的解码
+    for (auto it = m_queue.begin(); it != m_queue.end();) {
+        if (it->info.hasVcl && !it->info.isReference) {
+            m_bytes -= it->data.size();
+            it = m_queue.erase(it);
+            ++m_dropped;
+        } else {
+            ++it;
+        }
+    }
+
+    // 3. 仍然溢出，整体丢弃并等待下一个关键帧
+    if (m_queue.size() > m_maxPackets || overMemory()) {
+        m_dropped += m_queue.size();
+        m_queue.clear();
+        m_bytes = 0;
+        m_waitKeyFrame = true;
+        m_discontinuity = true;
+    }
+}
@@ -0,0 +1,74 @@
+#ifndef PACKETQUEUE_H
+#define PACKETQUEUE_H
+
+#include <QByteArray>
+#include <QQueue>
+#include <QMutex>
+
+#include "NalIndex.h"
+#include "MemoryBudget.h"
+
+#include <memory>
+
+// 网络线程与解码线程之间的有界码流包队列
+// 解码跟不上时排队的信号会无限堆积，延迟随之增长。这里按码流的 GOP 结构主动丢包:
+//   1. 队首等待时间超过延迟预算或包数超限时，跳到队列中最新的 IDR 或恢复点（连同其前面的参数集）
+//   2. 没有 IDR 可跳时丢弃非参考帧（H.264 nal_ref_idc == 0、HEVC 子层非参考图像、MJPEG 全部）
+//   3. 仍超出包数上限则清空队列，等待下一个关键帧再继续，避免参考链断裂花屏
+// 排队字节数超出 MemoryBudget 的额度时同样按以上顺序丢包。
+// push() 在网络线程调用，pop() 在解码线程调用。
+class PacketQueue
+{
+public:
+    struct Entry
+    {
+        QByteArray data;
+        NalIndex nals;
+        DeskVideoCodec codec = VIDEO_CODEC_H264;
+        qint64 receivedNs = 0;   // 进入队列的时间（StreamStats::nowNs）
+        PacketInfo info;
+        bool discontinuity = false;  // 此包之前有参考帧被丢弃，解码器需清空参考帧
+    };
+
+    // budget 为空时只按包数和延迟限制
+    PacketQueue(int maxPackets, int latencyBudgetMs, const std::shared_ptr<MemoryBudget>& budget = nullptr);
+
+    // 入队并按需丢弃过期包。返回 true 表示入队前队列为空，需要唤醒解码线程
+    bool push(const AccessUnit& unit);
+
+    // 取出队首，队列为空时返回 false；之前整体丢弃过时 entry.discontinuity 为 true
+    bool pop(Entry& entry);
+
+    // 清空并等待下一个关键帧（解码器重建等场景）
+    void reset();
+
+    int depth() const;
+    qint64 bytes() const;
+    quint64 droppedCount() const;
+    // 因超出延迟预算跳到最新 IDR 或恢复点的次数
+    quint64 idrSkipCount() const;
+
+    PacketQueue(const PacketQueue&) = delete;
+    PacketQueue& operator=(const PacketQueue&) = delete;
+
+private:
+    // 调用方持有 m_mutex
+    void trim(qint64 nowNs);
+    bool overBudget(qint64 nowNs) const;
+    bool overMemory() const;
+
+    mutable QMutex m_mutex;
+    QQueue<Entry> m_queue;
+    const int m_maxPackets;
+    const qint64 m_latencyBudgetNs;
+    std::shared_ptr<MemoryBudget> m_budget;
+    // 排队包的总字节数，入队、出队和丢包时增减，不重新遍历队列
+    qint64 m_bytes = 0;
+
+    bool m_waitKeyFrame = true;   // 启动或溢出清空后，只接受关键帧
+    bool m_discontinuity = false;
+    quint64 m_dropped = 0;
+    quint64 m_idrSkips = 0;
+};
+
+#endif // PACKETQUEUE_H
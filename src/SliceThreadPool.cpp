@@ -0,0 +1,146 @@
+#include "SliceThreadPool.h"
+
+SliceThreadPool::SliceThreadPool(int workerCount, const std::function<void(int)>& threadInit)
+{
+    workerCount = qMax(0, workerCount);
+    for (int i = 0; i < workerCount + 1; ++i)
+    {
+        m_ranges.append(new Range);
+    }
+
+    // 区间 0 属于调用线程，后台线程从 1 开始编号
+    for (int i = 0; i < workerCount; ++i)
+    {
+        QThread* thread = QThread::create([this, i, threadInit]() {
+            if (threadInit)
+            {
+                threadInit(i + 1);
+            }
+            workerLoop(i + 1);
+        });
+        thread->setObjectName(QString("SliceWorker%1").arg(i + 1));
+        thread->start();
+        m_workers.append(thread);
+    }
+}
+
+SliceThreadPool::~SliceThreadPool()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        m_quit = true;
+        m_startCond.wakeAll();
+    }
+
+    for (QThread* thread : m_workers)
+    {
+        thread->wait();
+        delete thread;
+    }
+    m_workers.clear();
+
+    qDeleteAll(m_ranges);
+    m_ranges.clear();
+}
+
+void SliceThreadPool::run(int sliceCount, const std::function<void(int)>& task, int threads)
+{
+    if (sliceCount <= 0)
+    {
+        return;
+    }
+
+    int participants = threads <= 0 ? maxThreads() : qMin(threads, maxThreads());
+    participants = qMin(participants, sliceCount);
+    if (participants <= 1)
+    {
+        for (int slice = 0; slice < sliceCount; ++slice)
+        {
+            task(slice);
+        }
+        return;
+    }
+
+    // 连续切片平均分给各参与线程，保持每个线程访问的内存相邻
+    for (int i = 0; i < participants; ++i)
+    {
+        m_ranges[i]->end = sliceCount * (i + 1) / participants;
+        m_ranges[i]->next.store(sliceCount * i / participants, std::memory_order_relaxed);
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_task = &task;
+        m_participants = participants;
+        m_busyWorkers = participants - 1;
+        ++m_generation;
+        m_startCond.wakeAll();
+    }
+
+    runSlices(0);
+
+    QMutexLocker locker(&m_mutex);
+    while (m_busyWorkers > 0)
+    {
+        m_doneCond.wait(&m_mutex);
+    }
+    m_task = nullptr;
+}
+
+void SliceThreadPool::workerLoop(int index)
+{
+    quint64 seenGeneration = 0;
+    while (true)
+    {
+        {
+            QMutexLocker locker(&m_mutex);
+            while (true)
+            {
+                if (m_quit)
+                {
+                    return;
+                }
+                if (m_generation != seenGeneration)
+                {
+                    seenGeneration = m_generation;
+                    if (index < m_participants)
+                    {
+                        break;
+                    }
+                }
+                m_startCond.wait(&m_mutex);
+            }
+        }
+
+        runSlices(index);
+
+        QMutexLocker locker(&m_mutex);
+        if (--m_busyWorkers == 0)
+        {
+            m_doneCond.wakeOne();
+        }
+    }
+}
+
+void SliceThreadPool::runSlices(int index)
+{
+    const std::function<void(int)>& task = *m_task;
+
+    // 先做自己的区间
+    Range* own = m_ranges[index];
+    int slice;
+    while ((slice = own->next.fetch_add(1)) < own->end)
+    {
+        task(slice);
+    }
+
+    // 再依次窃取其它线程尚未开始的切片
+    for (int k = 1; k < m_participants; ++k)
+    {
+        Range* victim = m_ranges[(index + k) % m_participants];
+        while ((slice = victim->next.fetch_add(1)) < victim->end)
+        {
+            task(slice);
+        }
+    }
+}
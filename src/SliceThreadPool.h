@@ -0,0 +1,57 @@
+#ifndef SLICETHREADPOOL_H
+#define SLICETHREADPOOL_H
+
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QVector>
+#include <atomic>
+#include <functional>
+
+// 常驻切片线程池，用于把一帧的色彩转换按水平条带分给多个核心
+// 线程在构造时创建并一直复用，每帧只做一次唤醒和一次完成等待。
+// 切片先按连续区间平均分给各参与线程（调用线程也参与），
+// 自己的区间做完后再从其它线程的区间窃取尚未开始的切片。
+class SliceThreadPool
+{
+public:
+    // workerCount 为后台线程数，总并行度为 workerCount + 1（调用线程）
+    // threadInit 在每个后台线程启动时以线程编号（从 1 开始）调用一次，用于设置 nice 和亲和性等线程级属性
+    explicit SliceThreadPool(int workerCount, const std::function<void(int)>& threadInit = nullptr);
+    ~SliceThreadPool();
+
+    int maxThreads() const { return m_workers.size() + 1; }
+
+    // 执行 task(0 .. sliceCount-1)，返回时全部切片已完成
+    // threads 限制本次参与的线程数（<= 0 表示全部），用于测量加速比
+    void run(int sliceCount, const std::function<void(int)>& task, int threads = 0);
+
+    SliceThreadPool(const SliceThreadPool&) = delete;
+    SliceThreadPool& operator=(const SliceThreadPool&) = delete;
+
+private:
+    // 每个参与线程负责的切片区间 [next, end)
+    struct Range
+    {
+        std::atomic<int> next{0};
+        int end = 0;
+    };
+
+    void workerLoop(int index);
+    void runSlices(int index);
+
+    QVector<QThread*> m_workers;
+    QVector<Range*> m_ranges;
+
+    QMutex m_mutex;
+    QWaitCondition m_startCond;
+    QWaitCondition m_doneCond;
+
+    const std::function<void(int)>* m_task = nullptr;
+    int m_participants = 0;      // 本轮参与线程数（含调用线程）
+    int m_busyWorkers = 0;       // 本轮尚未完成的后台线程
+    quint64 m_generation = 0;    // 每轮递增，唤醒后台线程
+    bool m_quit = false;
+};
+
+#endif // SLICETHREADPOOL_H
@@ -0,0 +1,72 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <QVector>
+#include <atomic>
+
+// 单生产者、单消费者的有界无锁环形队列
+// 生产者只写 m_tail，消费者只写 m_head，push/pop 各一次 acquire 读 + 一次 release 写。
+// 容量向上取整到 2 的幂；队列满或空时立即返回 false，需要阻塞时由调用方配合信号量等待。
+template <typename T>
+class SpscQueue
+{
+public:
+    explicit SpscQueue(int capacity)
+    {
+        int size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    int capacity() const { return m_slots.size(); }
+
+    // 生产者线程调用
+    bool push(const T& value)
+    {
+        quint64 tail = m_tail.load(std::memory_order_relaxed);
+        if (tail - m_head.load(std::memory_order_acquire) >= static_cast<quint64>(m_slots.size()))
+        {
+            return false;
+        }
+        m_slots[static_cast<int>(tail & m_mask)] = value;
+        m_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 消费者线程调用
+    bool pop(T& value)
+    {
+        quint64 head = m_head.load(std::memory_order_relaxed);
+        if (head == m_tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        T& slot = m_slots[static_cast<int>(head & m_mask)];
+        value = slot;
+        slot = T();
+        m_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // 任意线程读取的近似长度，仅用于统计
+    int size() const
+    {
+        return static_cast<int>(m_tail.load(std::memory_order_acquire) - m_head.load(std::memory_order_acquire));
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+private:
+    QVector<T> m_slots;
+    quint64 m_mask = 0;
+    // 生产者与消费者的下标分处不同缓存行，避免伪共享
+    alignas(64) std::atomic<quint64> m_head{0};
+    alignas(64) std::atomic<quint64> m_tail{0};
+};
+
+#endif // SPSCQUEUE_H
@@ -0,0 +1,26 @@
+#include "StageMeter.h"
+#include "StreamStats.h"
+
+StageMeter::StageMeter(const QString& name)
+    : m_busyKey(QString("stage.%1.busyPct").arg(name))
+    , m_stallKey(QString("stage.%1.stallPct").arg(name))
+    , m_windowStartNs(StreamStats::nowNs())
+{
+}
+
+void StageMeter::report(qint64 intervalMs)
+{
+    qint64 now = StreamStats::nowNs();
+    qint64 windowNs = now - m_windowStartNs;
+    if (windowNs < intervalMs * 1000000)
+    {
+        return;
+    }
+
+    StreamStats* stats = StreamStats::instance();
+    stats->setValue(m_busyKey, qMin<qint64>(100, m_busyNs * 100 / windowNs));
+    stats->setValue(m_stallKey, qMin<qint64>(100, m_stallNs * 100 / windowNs));
+    m_windowStartNs = now;
+    m_busyNs = 0;
+    m_stallNs = 0;
+}
@@ -0,0 +1,31 @@
+#ifndef STAGEMETER_H
+#define STAGEMETER_H
+
+#include <QString>
+
+// 流水线某一阶段的占用率统计
+// 阶段所在线程累计处理耗时（busy）和等待下游的阻塞耗时（stall），
+// 每隔一段时间按墙钟时间折算成百分比写入 StreamStats:
+//   stage.<name>.busyPct  处理占用率，接近 100 说明该阶段是瓶颈
+//   stage.<name>.stallPct 被下游队列反压的比例，说明瓶颈在下游
+// 只能在单个线程内使用。
+class StageMeter
+{
+public:
+    explicit StageMeter(const QString& name);
+
+    void addBusy(qint64 ns) { m_busyNs += ns; }
+    void addStall(qint64 ns) { m_stallNs += ns; }
+
+    // 距上次输出超过 intervalMs 时写入 StreamStats 并清零
+    void report(qint64 intervalMs = 1000);
+
+private:
+    QString m_busyKey;
+    QString m_stallKey;
+    qint64 m_windowStartNs = 0;
+    qint64 m_busyNs = 0;
+    qint64 m_stallNs = 0;
+};
+
+#endif // STAGEMETER_H
@@ -0,0 +1,185 @@
+#include "StreamParser.h"
+#include "H264Nal.h"
+
+#include <QtGlobal>
+
+// HEVC NAL 单元类型（H.265 表 7-1）
+enum HevcNalType
+{
+    HEVC_NAL_BLA_W_LP   = 16,
+    HEVC_NAL_CRA        = 21,
+    HEVC_NAL_VPS        = 32,
+    HEVC_NAL_SPS        = 33,
+    HEVC_NAL_PPS        = 34,
+    HEVC_NAL_AUD        = 35,
+    HEVC_NAL_SEI_PREFIX = 39
+};
+
+// JPEG SOI 标记
+#define JPEG_SOI 0xD8
+
+static bool startsWithStartCode(const uint8_t* data, int size, int* headerPos)
+{
+    if (size >= 4 && data[0] == 0 && data[1] == 0 && data[2] == 1) {
+        *headerPos = 3;
+        return true;
+    }
+    if (size >= 5 && data[0] == 0 && data[1] == 0 && data[2] == 0 && data[3] == 1) {
+        *headerPos = 4;
+        return true;
+    }
+    return false;
+}
+
+// 两字节 HEVC NAL 头: forbidden_zero(1) type(6) layer_id(6) temporal_id_plus1(3)
+// 只接受码流开头常见的类型，且 layer_id 为 0、temporal_id_plus1 非 0
+static bool looksLikeHevcHeader(uint8_t b0, uint8_t b1)
+{
+    if ((b0 & 0x81) != 0 || (b1 & 0xF8) != 0 || (b1 & 0x07) == 0) {
+        return false;
+    }
+    int type = (b0 >> 1) & 0x3F;
+    return type == HEVC_NAL_VPS || type == HEVC_NAL_SPS || type == HEVC_NAL_PPS || type == HEVC_NAL_AUD
+        || type == HEVC_NAL_SEI_PREFIX || (type >= HEVC_NAL_BLA_W_LP && type <= HEVC_NAL_CRA) || type <= 1;
+}
+
+DeskVideoCodec sniffVideoCodec(const uint8_t* data, int size)
+{
+    if (size >= 3 && data[0] == 0xFF && data[1] == JPEG_SOI && data[2] == 0xFF) {
+        return VIDEO_CODEC_MJPEG;
+    }
+
+    int headerPos = 0;
+    if (startsWithStartCode(data, size, &headerPos)) {
+        if (headerPos + 1 < size && looksLikeHevcHeader(data[headerPos], data[headerPos + 1])) {
+            return VIDEO_CODEC_HEVC;
+        }
+        int type = data[headerPos] & 0x1F;
+        if ((data[headerPos] & 0x80) == 0 && type >= H264_NAL_SLICE && type <= H264_NAL_AUD) {
+            return VIDEO_CODEC_H264;
+        }
+        return VIDEO_CODEC_AUTO;
+    }
+
+    return VIDEO_CODEC_AUTO;
+}
+
+const char* videoCodecName(DeskVideoCodec codec)
+{
+    switch (codec)
+    {
+    case VIDEO_CODEC_H264:
+        return "h264";
+    case VIDEO_CODEC_HEVC:
+        return "hevc";
+    case VIDEO_CODEC_MJPEG:
+        return "mjpeg";
+    default:
+        return "auto";
+    }
+}
+
+static void indexHevcNals(const uint8_t* data, int size, NalIndex& index)
+{
+    int pos = findH264StartCode(data, size, 0);
+    while (pos + 4 < size) {
+        NalUnit nal;
+        nal.offset = pos + 3;
+        nal.type = (data[nal.offset] >> 1) & 0x3F;
+
+        pos = findH264StartCode(data, size, nal.offset);
+        int end = pos;
+        while (end > nal.offset + 2 && data[end - 1] == 0) {
+            --end;
+        }
+        nal.size = end - nal.offset;
+        index.append(nal);
+    }
+}
+
+void indexStreamUnits(DeskVideoCodec codec, const uint8_t* data, int size, NalIndex& index)
+{
+    switch (codec)
+    {
+    case VIDEO_CODEC_H264:
+        indexH264Nals(data, size, index);
+        break;
+    case VIDEO_CODEC_HEVC:
+        index.clear();
+        indexHevcNals(data, size, index);
+        break;
+    case VIDEO_CODEC_MJPEG:
+    {
+        index.clear();
+        NalUnit unit;
+        unit.type = JPEG_SOI;
+        unit.size = size;
+        index.append(unit);
+        break;
+    }
+    default:
+        index.clear();
+        break;
+    }
+}
+
+static PacketInfo summarizeHevcNals(const uint8_t* data, const NalIndex& index)
+{
+    PacketInfo info;
+    for (const NalUnit& nal : index) {
+        if (nal.type < HEVC_NAL_VPS) {
+            // first_slice_segment_in_pic_flag 是片头第一个比特
+            if (!info.hasVcl && nal.size > 2) {
+                info.startsPicture = (data[nal.offset + 2] & 0x80) != 0;
+            }
+            info.hasVcl = true;
+            // 16 以下的偶数类型（TRAIL_N、RASL_N 等）是子层非参考图像
+            if (nal.type >= HEVC_NAL_BLA_W_LP || (nal.type & 1)) {
+                info.isReference = true;
+            }
+            // IRAP（BLA/IDR/CRA）可作为随机接入点
+            if (nal.type >= HEVC_NAL_BLA_W_LP && nal.type <= HEVC_NAL_CRA) {
+                info.hasIdr = true;
+            }
+        }
+        if (nal.type == HEVC_NAL_VPS || nal.type == HEVC_NAL_SPS) {
+            info.hasSps = true;
+        }
+    }
+    return info;
+}
+
+PacketInfo summarizeStreamUnits(DeskVideoCodec codec, const uint8_t* data, const NalIndex& index)
+{
+    switch (codec)
+    {
+    case VIDEO_CODEC_H264:
+        return summarizeH264Nals(data, index);
+    case VIDEO_CODEC_HEVC:
+        return summarizeHevcNals(data, index);
+    case VIDEO_CODEC_MJPEG:
+    {
+        // 每帧独立解码，任何一帧都可以丢弃或作为起点
+        PacketInfo info;
+        info.hasIdr = !index.isEmpty();
+        info.hasVcl = info.hasIdr;
+        info.startsPicture = info.hasIdr;
+        return info;
+    }
+    default:
+        return PacketInfo();
+    }
+}
+
+bool isParameterSetUnit(DeskVideoCodec codec, int type)
+{
+    switch (codec)
+    {
+    case VIDEO_CODEC_H264:
+        return type == H264_NAL_SPS || type == H264_NAL_PPS;
+    case VIDEO_CODEC_HEVC:
+        return type == HEVC_NAL_VPS || type == HEVC_NAL_SPS || type == HEVC_NAL_PPS;
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,34 @@
+#ifndef STREAMPARSER_H
+#define STREAMPARSER_H
+
+#include <cstdint>
+
+#include "NalIndex.h"
+
+// 按编码格式建立数据包索引和结构概要
+// H.264 交给 H264Nal；HEVC 同为 Annex-B 起始码分隔，NAL 头为两字节；
+// MJPEG 每包一帧、帧间无依赖。
+// 不识别 AV1: 随附的 FFmpeg 没有 AV1 软件解码器（libdav1d/libaom）。
+
+// 根据码流开头识别编码格式，无法识别时返回 VIDEO_CODEC_AUTO
+DeskVideoCodec sniffVideoCodec(const uint8_t* data, int size);
+
+// 配置文件与日志中的编码格式名称
+const char* videoCodecName(DeskVideoCodec codec);
+
+// 建立包内全部 NAL 的索引（先清空 index）
+void indexStreamUnits(DeskVideoCodec codec, const uint8_t* data, int size, NalIndex& index);
+
+// 由索引得到包的结构概要
+PacketInfo summarizeStreamUnits(DeskVideoCodec codec, const uint8_t* data, const NalIndex& index);
+
+// 是否为参数集（解码器重启时作为 extradata 注入）
+bool isParameterSetUnit(DeskVideoCodec codec, int type);
+
+// 参数集在 extradata 中是否需要 Annex-B 起始码
+inline bool usesStartCodes(DeskVideoCodec codec)
+{
+    return codec == VIDEO_CODEC_H264 || codec == VIDEO_CODEC_HEVC;
+}
+
+#endif // STREAMPARSER_H
@@ -0,0 +1,42 @@
+#include "StreamRecorder.h"
+#include "LogWidget.h"
+
+#include <QtEndian>
+
+StreamRecorder::~StreamRecorder()
+{
+    close();
+}
+
+bool StreamRecorder::open(const QString& path)
+{
+    close();
+    m_file.setFileName(path);
+    if (!m_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        LogWidget::instance()->addLog(QString("Could not open stream recording: %1").arg(path), LogWidget::Warning);
+        return false;
+    }
+    LogWidget::instance()->addLog(QString("Recording stream to %1").arg(path), LogWidget::Info);
+    return true;
+}
+
+void StreamRecorder::close()
+{
+    if (m_file.isOpen())
+    {
+        m_file.close();
+    }
+}
+
+void StreamRecorder::write(const QByteArray& message)
+{
+    if (!m_file.isOpen())
+    {
+        return;
+    }
+    uchar length[4];
+    qToBigEndian<quint32>(quint32(message.size()), length);
+    m_file.write(reinterpret_cast<const char*>(length), sizeof(length));
+    m_file.write(message);
+}
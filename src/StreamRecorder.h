@@ -0,0 +1,29 @@
+#ifndef STREAMRECORDER_H
+#define STREAMRECORDER_H
+
+#include <QFile>
+#include <QByteArray>
+
+// 原始码流录制
+// 每条网络消息写为 4 字节大端长度 + 消息内容，benchmarks/bench_decode 按消息边界原样回放，
+// 用于在同一段桌面内容上比较不同编码格式和设备的解码耗时。
+class StreamRecorder
+{
+public:
+    StreamRecorder() = default;
+    ~StreamRecorder();
+
+    bool open(const QString& path);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+
+    void write(const QByteArray& message);
+
+    StreamRecorder(const StreamRecorder&) = delete;
+    StreamRecorder& operator=(const StreamRecorder&) = delete;
+
+private:
+    QFile m_file;
+};
+
+#endif // STREAMRECORDER_H
@@ -0,0 +1,75 @@
+#include "StreamStats.h"
+#include "LogWidget.h"
+
+#include <QStringList>
+#include <chrono>
+#include <ctime>
+
+StreamStats::StreamStats()
+{
+    m_reportTimer.start();
+}
+
+void StreamStats::setValue(const QString& key, const QVariant& value)
+{
+    QMutexLocker locker(&m_mutex);
+    m_values.insert(key, value);
+}
+
+void StreamStats::addValue(const QString& key, qint64 delta)
+{
+    QMutexLocker locker(&m_mutex);
+    m_values.insert(key, m_values.value(key).toLongLong() + delta);
+}
+
+qint64 StreamStats::value(const QString& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_values.value(key).toLongLong();
+}
+
+QVariantMap StreamStats::snapshot() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_values;
+}
+
+qint64 StreamStats::nowNs()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+qint64 StreamStats::processCpuNs()
+{
+#ifdef Q_OS_UNIX
+    // clock() 在 32 位 Android 上约 36 分钟回绕，直接读进程 CPU 时钟
+    timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) == 0)
+    {
+        return qint64(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+    }
+#endif
+    return qint64(std::clock()) * 1000000000 / CLOCKS_PER_SEC;
+}
+
+void StreamStats::reportIfDue(qint64 intervalMs)
+{
+    QStringList items;
+    {
+        QMutexLocker locker(&m_mutex);
+        if (m_reportTimer.elapsed() < intervalMs)
+        {
+            return;
+        }
+        m_reportTimer.restart();
+
+        for (auto it = m_values.constBegin(); it != m_values.constEnd(); ++it)
+        {
+            items << QString("%1=%2").arg(it.key(), it.value().toString());
+        }
+    }
+
+    // 日志在锁外输出，避免 LogWidget 跨线程投递时持有锁
+    LogWidget::instance()->addLog("[Stats] " + items.join(", "), LogWidget::Info);
+}
@@ -0,0 +1,49 @@
+#ifndef STREAMSTATS_H
+#define STREAMSTATS_H
+
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+#include <QMutex>
+#include <QElapsedTimer>
+
+// 视频流运行指标汇总（线程安全单例）
+// 各线程按 "模块.指标" 命名写入，定期汇总输出到日志
+class StreamStats
+{
+public:
+    static StreamStats* instance()
+    {
+        static StreamStats stats;
+        return &stats;
+    }
+
+    // 覆盖写入指标
+    void setValue(const QString& key, const QVariant& value);
+    // 计数类指标累加
+    void addValue(const QString& key, qint64 delta = 1);
+    qint64 value(const QString& key) const;
+
+    // 当前所有指标的拷贝
+    QVariantMap snapshot() const;
+
+    // 距上次输出超过 intervalMs 时把全部指标写一行日志
+    void reportIfDue(qint64 intervalMs = 5000);
+
+    // 各线程共用的单调时钟（纳秒），用于计算跨线程延迟
+    static qint64 nowNs();
+    // 整个进程累计消耗的 CPU 时间（纳秒，所有线程之和）
+    static qint64 processCpuNs();
+
+    StreamStats(const StreamStats&) = delete;
+    StreamStats& operator=(const StreamStats&) = delete;
+
+private:
+    StreamStats();
+
+    mutable QMutex m_mutex;
+    QVariantMap m_values;
+    QElapsedTimer m_reportTimer;
+};
+
+#endif // STREAMSTATS_H
@@ -0,0 +1,173 @@
+#include "ThreadTuning.h"
+#include "LogWidget.h"
+#include "StreamStats.h"
+
+#include <QFile>
+#include <QStringList>
+#include <QThread>
+#include <algorithm>
+
+#ifdef Q_OS_LINUX
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+static const char* CORE_SET_NAMES[] = { "any", "big", "little" };
+
+const char* coreSetName(DeskCoreSet cores)
+{
+    return CORE_SET_NAMES[cores];
+}
+
+#ifdef Q_OS_LINUX
+static int readSysfsInt(const QString& path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return -1;
+    }
+    bool ok = false;
+    int value = file.readAll().trimmed().toInt(&ok);
+    return ok ? value : -1;
+}
+
+static QVector<int> readCpuValues(int cpuCount, const char* node)
+{
+    QVector<int> values;
+    for (int cpu = 0; cpu < cpuCount; ++cpu)
+    {
+        int value = readSysfsInt(QString("/sys/devices/system/cpu/cpu%1/%2").arg(cpu).arg(node));
+        if (value <= 0)
+        {
+            return QVector<int>();
+        }
+        values << value;
+    }
+    return values;
+}
+
+// CPU 编号列表，例如 "0,1,2,3"
+static QString currentAffinity()
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) != 0)
+    {
+        return "?";
+    }
+    QStringList cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+    {
+        if (CPU_ISSET(cpu, &set))
+        {
+            cpus << QString::number(cpu);
+        }
+    }
+    return cpus.join(",");
+}
+#endif
+
+QVector<int> cpuCapacities()
+{
+#ifdef Q_OS_LINUX
+    int cpuCount = static_cast<int>(sysconf(_SC_NPROCESSORS_CONF));
+    // 部分核心离线时 cpufreq 节点可能缺失，任何一个读不到就整体放弃，避免半份数据误判大小核
+    QVector<int> capacities = readCpuValues(cpuCount, "cpu_capacity");
+    if (capacities.isEmpty())
+    {
+        capacities = readCpuValues(cpuCount, "cpufreq/cpuinfo_max_freq");
+    }
+    return capacities;
+#else
+    return QVector<int>();
+#endif
+}
+
+QVector<int> cpusForCoreSet(DeskCoreSet cores)
+{
+    QVector<int> capacities = cpuCapacities();
+    QVector<int> cpus;
+    if (capacities.isEmpty())
+    {
+        for (int cpu = 0; cpu < QThread::idealThreadCount(); ++cpu)
+        {
+            cpus << cpu;
+        }
+        return cpus;
+    }
+
+    int maxCapacity = *std::max_element(capacities.begin(), capacities.end());
+    int minCapacity = *std::min_element(capacities.begin(), capacities.end());
+    // 三簇（超大核 + 大核 + 小核）时中大核都算大核
+    int middle = (maxCapacity + minCapacity) / 2;
+    for (int cpu = 0; cpu < capacities.size(); ++cpu)
+    {
+        bool big = capacities[cpu] > middle;
+        if (cores == CORES_ANY || maxCapacity == minCapacity
+            || (cores == CORES_BIG && big) || (cores == CORES_LITTLE && !big))
+        {
+            cpus << cpu;
+        }
+    }
+    return cpus;
+}
+
+void setCurrentThreadPolicy(const DeskThreadPolicy& policy, QStringList& errors)
+{
+#ifdef Q_OS_LINUX
+    // Linux 的 nice 是线程级的，以 tid 作为 PRIO_PROCESS 的对象只影响当前线程
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    if (setpriority(PRIO_PROCESS, tid, policy.nice) != 0)
+    {
+        errors << QString("setpriority(%1): %2").arg(policy.nice).arg(strerror(errno));
+    }
+    if (policy.cores != CORES_ANY)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpusForCoreSet(policy.cores))
+        {
+            CPU_SET(cpu, &set);
+        }
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        {
+            errors << QString("sched_setaffinity(%1): %2").arg(coreSetName(policy.cores)).arg(strerror(errno));
+        }
+    }
+#else
+    QThread::currentThread()->setPriority(policy.nice < 0 ? QThread::HighPriority
+                                          : policy.nice > 0 ? QThread::LowPriority
+                                                            : QThread::NormalPriority);
+#endif
+}
+
+bool applyThreadPolicy(const QString& name, const DeskThreadPolicy& policy)
+{
+    QStringList errors;
+    setCurrentThreadPolicy(policy, errors);
+
+#ifdef Q_OS_LINUX
+    // 读回实际生效的值，确认内核接受了设置
+    pid_t tid = static_cast<pid_t>(syscall(SYS_gettid));
+    errno = 0;
+    int nice = getpriority(PRIO_PROCESS, tid);
+    QString cpus = currentAffinity();
+    StreamStats::instance()->setValue(QString("thread.%1.nice").arg(name), nice);
+    StreamStats::instance()->setValue(QString("thread.%1.cpus").arg(name), cpus);
+    LogWidget::instance()->addLog(QString("Thread %1: nice %2 (requested %3), cpus %4 (%5)")
+                                      .arg(name).arg(nice).arg(policy.nice).arg(cpus)
+                                      .arg(coreSetName(policy.cores)), LogWidget::Info);
+#endif
+
+    if (!errors.isEmpty())
+    {
+        LogWidget::instance()->addLog(QString("Thread %1 policy not fully applied: %2")
+                                          .arg(name).arg(errors.join("; ")), LogWidget::Warning);
+    }
+    return errors.isEmpty();
+}
@@ -0,0 +1,30 @@
+#ifndef THREADTUNING_H
+#define THREADTUNING_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+#include "DeskDefine.h"
+
+// 流水线线程的调度策略: nice 优先级和按大小核选择的 CPU 亲和性
+// Linux/Android 上 nice 和亲和性都是线程级的，必须在目标线程内应用；
+// QThread::setPriority 对 SCHED_OTHER 线程不起作用，这里直接用 setpriority/sched_setaffinity，
+// 其它平台只把 nice 映射到 QThread 优先级。
+
+// 各 CPU 的相对算力，来自 sysfs cpu_capacity（EAS 内核），没有时退化为最高主频；读不到时为空
+QVector<int> cpuCapacities();
+
+// 核心集合包含的 CPU 编号；算力以最高和最低的中点划分大小核，无法区分时返回全部 CPU
+QVector<int> cpusForCoreSet(DeskCoreSet cores);
+
+const char* coreSetName(DeskCoreSet cores);
+
+// 设置当前线程的 nice 和亲和性，出错原因写入 errors，不写日志
+void setCurrentThreadPolicy(const DeskThreadPolicy& policy, QStringList& errors);
+
+// 把策略应用到当前线程，读回实际生效的 nice 和亲和性写入日志和 StreamStats（thread.<name>.*）
+// 返回 false 表示有设置被内核拒绝（例如没有降低 nice 的权限），线程仍按原状态运行
+bool applyThreadPolicy(const QString& name, const DeskThreadPolicy& policy);
+
+#endif // THREADTUNING_H
@@ -1,74 +1,176 @@
 #include "VideoDecoderWorker.h"
 #include "LogWidget.h"
+#include "StreamStats.h"
+#include "H264Nal.h"
+#include "StreamParser.h"
+#include "ThreadTuning.h"
 
 #include <QElapsedTimer>
+#include <QPixmap>
+#include <QThread>
+#include <QtMath>
 #include <QDebug>
 
-#define QUEUE_IMAGE 10
-
-// 手动分析H264数据流，判断是否包含关键帧(IDR或SPS)
-static bool isH264KeyFrame(const QByteArray &data) {
-    const uint8_t *bytes = reinterpret_cast<const uint8_t *>(data.constData());
-    int size = data.size();
-
-    // 只需要扫描前 100 个字节通常就足够找到 NAL 头了，为了保险扫描整个包
-    // H264 NAL起始码通常是 00 00 00 01 或 00 00 01
-    for (int i = 0; i < size - 4; ++i) {
-        if (bytes[i] == 0 && bytes[i+1] == 0) {
-            int nalTypeLocation = 0;
-            if (bytes[i+2] == 1) {
-                // 00 00 01 XX
-                nalTypeLocation = i + 3;
-            } else if (bytes[i+2] == 0 && bytes[i+3] == 1) {
-                // 00 00 00 01 XX
-                nalTypeLocation = i + 4;
-            }
+#include <cstring>
 
-            if (nalTypeLocation > 0 && nalTypeLocation < size) {
-                // NAL Unit Type 位于字节的低 5 位
-                int type = bytes[nalTypeLocation] & 0x1F;
+// 每个转换线程分到的切片数，多切一些便于空闲线程窃取
+#define SLICES_PER_THREAD 4
 
-                // Type 5: IDR(关键帧)
-                // Type 7: SPS(序列参数集，通常关键帧前会有这个)
-                if (type == 5 || type == 7) {
-                    return true;
-                }
+// 转换线程数上限，留出核心给解码和 UI
+#define MAX_CONVERT_THREADS 4
 
-                // 跳过这个 NAL 头，继续寻找下一个
-                i = nalTypeLocation;
-            }
-        }
+// 解码器切片线程数上限
+#define MAX_DECODE_THREADS 4
+
+// MJPEG 并行解码线程数上限
+#define MAX_MJPEG_THREADS 8
+
+// MJPEG 线程池中排队等待解码的帧数上限（每个线程）
+#define MJPEG_PENDING_PER_THREAD 2
+
+// 拆分拓扑下解码与转换之间的队列长度: 转换当前帧的同时解码下一帧，再多只会增加延迟
+#define CONVERT_QUEUE_SIZE 2
+
+// avcodec_send_packet 连续失败这么多次后重启解码器
+#define MAX_SEND_ERROR_RUN 8
+
+// 每处理多少个包（转换线程按帧）汇总一次统计，StreamStats 每次写入都要构造键值并加锁
+#define DECODER_STATS_INTERVAL 120
+
+// 解码器到 VideoWidget 之间同时在途的帧数:
+// 正在写入 1 + 邮箱中间槽 1 + VideoWidget 当前显示 1，再留 1 个余量
+// （拆分拓扑下转换队列里是解码器的 YUV 帧引用，不占用这里的 RGB 缓冲；
+//  变化检测保留的上一帧就是最近发布的那一帧，与邮箱或 VideoWidget 共用缓冲）
+#define FRAME_POOL_SIZE 4
+
+// 变化块覆盖的像素不超过这个比例时才只转换变化块，否则整帧转换
+// bench_blockhash（1080p）: 整帧转换约 1.9ms；变化 5% 时按块转换加拷贝未变化块为 1.4-1.7ms，
+// 块分散时到 10% 已与整帧转换持平
+#define PARTIAL_CONVERT_MAX_PERCENT 5
+
+QImage::Format VideoDecoderWorker::frameFormatFor(DeskPixelFormat pixelFormat)
+{
+    switch (pixelFormat)
+    {
+    case PIXEL_FORMAT_RGB16:
+        return QImage::Format_RGB16;
+    case PIXEL_FORMAT_RGB32:
+        return QImage::Format_RGB32;
+    default:
+        // 光栅引擎只对 RGB32/ARGB32_Premultiplied 和屏幕本身的 16 位格式走快速路径
+        return QPixmap::defaultDepth() == 16 ? QImage::Format_RGB16 : QImage::Format_RGB32;
     }
-    return false;
 }
 
-VideoDecoderWorker::VideoDecoderWorker(QObject* parent)
+// QImage 格式对应的 swscale 目标格式（均为本机字节序）
+static AVPixelFormat swsFormatFor(QImage::Format format)
+{
+    switch (format)
+    {
+    case QImage::Format_RGB16:
+        return AV_PIX_FMT_RGB565;
+    case QImage::Format_RGBA8888:
+        return AV_PIX_FMT_RGBA;
+    default:
+        // Format_RGB32 即本机序 0xffRRGGBB，小端下与 AV_PIX_FMT_BGRA 相同
+        return AV_PIX_FMT_RGB32;
+    }
+}
+
+// 编码格式对应的 FFmpeg 解码器，均为随 FFmpeg 发布的软件解码器
+static AVCodecID avCodecIdFor(DeskVideoCodec videoCodec)
+{
+    switch (videoCodec)
+    {
+    case VIDEO_CODEC_HEVC:
+        return AV_CODEC_ID_HEVC;
+    case VIDEO_CODEC_MJPEG:
+        return AV_CODEC_ID_MJPEG;
+    default:
+        return AV_CODEC_ID_H264;
+    }
+}
+
+VideoDecoderWorker::VideoDecoderWorker(const DeskVideoConfig& config, const std::shared_ptr<PacketQueue>& packetQueue,
+                                       const std::shared_ptr<FrameMailbox>& mailbox,
+                                       const std::shared_ptr<MemoryBudget>& memoryBudget, QObject* parent)
     : QObject(parent)
+    , m_framePool(FRAME_POOL_SIZE)
+    , m_memoryBudget(memoryBudget)
+    , m_packetQueue(packetQueue)
+    , m_mailbox(mailbox)
+    , m_governor(config.adaptiveQuality)
 {
     m_isFirstKeyFrameReceived = false;
 
+    m_imageFormat = frameFormatFor(config.pixelFormat);
+    m_swsFormat = swsFormatFor(m_imageFormat);
+
+    // 转换线程数: 配置为 0 时取核心数的一半，解码线程本身也参与切片
+    int convertThreads = config.convertThreads;
+    if (convertThreads <= 0) {
+        convertThreads = qBound(1, QThread::idealThreadCount() / 2, MAX_CONVERT_THREADS);
+    }
+    // 切片线程做的是色彩转换，与转换线程使用同一调度策略
+    m_convertPolicy = config.convertThread;
+    if (convertThreads > 1) {
+        DeskThreadPolicy policy = m_convertPolicy;
+        m_slicePool.reset(new SliceThreadPool(convertThreads - 1, [policy](int index) {
+            applyThreadPolicy(QString("slice%1").arg(index), policy);
+        }));
+    }
+    m_changeDetection = config.changeDetection;
+    LogWidget::instance()->addLog(QString("Decoder output format: %1 (sws %2), yuv kernel: %3, convert threads: %4, "
+                                          "change detection: %5")
+                                      .arg(m_imageFormat).arg(av_get_pix_fmt_name(m_swsFormat))
+                                      .arg(YuvConverter::kernelName(m_yuvConverter.kernel()))
+                                      .arg(m_slicePool ? m_slicePool->maxThreads() : 1)
+                                      .arg(m_changeDetection ? BlockHasher::kernelName(m_blockHasher.kernel()) : "off"),
+                                  LogWidget::Info);
+
     // FFmpeg 初始化
-    codec = avcodec_find_decoder(AV_CODEC_ID_H264);
-    if (!codec)
+    m_decodeThreads = config.decodeThreads > 0
+        ? config.decodeThreads
+        : qBound(1, QThread::idealThreadCount(), MAX_DECODE_THREADS);
+    frame = av_frame_alloc();
+    m_lastFrame = av_frame_alloc();
+    m_cropFrame = av_frame_alloc();
+    if (!frame || !m_lastFrame || !m_cropFrame)
     {
-        LogWidget::instance()->addLog(QString("H264 decoder not found"), LogWidget::Error);
-        return;
+        LogWidget::instance()->addLog(QString("Could not allocate video frame"), LogWidget::Error);
     }
-    codecCtx = avcodec_alloc_context3(codec);
-    if (!codecCtx)
+    m_packet = av_packet_alloc();
+    if (!m_packet)
     {
-        LogWidget::instance()->addLog(QString("Could not allocate video codec context"), LogWidget::Error);
-        return;
+        LogWidget::instance()->addLog(QString("Could not allocate AVPacket"), LogWidget::Error);
     }
-    if (avcodec_open2(codecCtx, codec, nullptr) < 0)
-    {
-        LogWidget::instance()->addLog(QString("Could not open codec"), LogWidget::Error);
-        return;
+    m_mjpegThreads = config.mjpegDecodeThreads > 0
+        ? qMin(config.mjpegDecodeThreads, MAX_MJPEG_THREADS)
+        : qBound(1, QThread::idealThreadCount(), MAX_MJPEG_THREADS);
+    LogWidget::instance()->addLog(QString("Decoder threads: %1 (slice), mjpeg threads: %2, adaptive quality: %3, codec: %4")
+                                      .arg(m_decodeThreads).arg(m_mjpegThreads)
+                                      .arg(config.adaptiveQuality ? "on" : "off")
+                                      .arg(videoCodecName(config.codec)),
+                                  LogWidget::Info);
+
+    // 拆分拓扑: 色彩转换放到独立线程，与下一帧的解码重叠
+    // 自动时 4 核及以上才拆分，核心少时多一个线程只会互相抢占
+    DeskPipelineTopology topology = config.pipeline;
+    if (topology == PIPELINE_AUTO) {
+        topology = QThread::idealThreadCount() >= 4 ? PIPELINE_SPLIT : PIPELINE_FUSED;
     }
-    frame = av_frame_alloc();
-    if (!frame)
-    {
-        LogWidget::instance()->addLog(QString("Could not allocate video frame"), LogWidget::Error);
+    if (topology == PIPELINE_SPLIT) {
+        startConvertThread();
+    }
+    LogWidget::instance()->addLog(QString("Pipeline: receive+parse | decode%1 | present")
+                                      .arg(m_convertThread ? " | convert" : "+convert"), LogWidget::Info);
+
+    // 配置了编码格式时立即打开解码器，否则等第一个数据包识别出格式后再打开
+    // 并行 MJPEG 不使用 codecCtx，线程池等第一帧到达时再创建
+    m_configuredCodec = config.codec;
+    m_videoCodec = config.codec;
+    if (m_videoCodec != VIDEO_CODEC_AUTO && !(m_videoCodec == VIDEO_CODEC_MJPEG && m_mjpegThreads > 1)) {
+        openDecoder();
     }
 
     // m_timer = new QTimer(this);
@@ -113,6 +215,140 @@ VideoDecoderWorker::VideoDecoderWorker(QObject* parent)
     // m_timer->start();
 }
 
+void VideoDecoderWorker::switchCodec(DeskVideoCodec videoCodec)
+{
+    if (codecCtx) {
+        avcodec_free_context(&codecCtx);
+        codecCtx = nullptr;
+    }
+    // 参数集属于旧格式，不能注入新解码器
+    m_parameterSets.clear();
+    m_videoCodec = videoCodec;
+    m_isFirstKeyFrameReceived = false;
+    m_sendErrorRun = 0;
+    if (m_mjpegPool) {
+        m_mjpegPool->clear();
+    }
+    // 邮箱只允许一个发布者，旧格式的帧转换完后再交给 MJPEG 线程池
+    waitConvertIdle();
+    // 上一帧属于旧格式（并行 MJPEG 也不会再更新它），不能在可见区域变化时拿来重新转换
+    if (m_lastFrame) {
+        av_frame_unref(m_lastFrame);
+    }
+    // 并行 MJPEG 由线程池里各自的解码器解码
+    if (videoCodec == VIDEO_CODEC_MJPEG && m_mjpegThreads > 1) {
+        LogWidget::instance()->addLog(QString("Video decoder: %1 (%2 parallel decoders)")
+                                          .arg(videoCodecName(videoCodec)).arg(m_mjpegThreads), LogWidget::Info);
+        return;
+    }
+    if (openDecoder()) {
+        if (m_governor.level() != DecodeGovernor::LevelFull) {
+            applyDecodeLevel(m_governor.level());
+        }
+        LogWidget::instance()->addLog(QString("Video decoder: %1 (%2)")
+                                          .arg(videoCodecName(videoCodec)).arg(codec->name), LogWidget::Info);
+    }
+}
+
+bool VideoDecoderWorker::openDecoder()
+{
+    codec = avcodec_find_decoder(avCodecIdFor(m_videoCodec));
+    if (!codec)
+    {
+        LogWidget::instance()->addLog(QString("%1 decoder not found").arg(videoCodecName(m_videoCodec)),
+                                      LogWidget::Error);
+        return false;
+    }
+    codecCtx = avcodec_alloc_context3(codec);
+    if (!codecCtx)
+    {
+        LogWidget::instance()->addLog(QString("Could not allocate video codec context"), LogWidget::Error);
+        return false;
+    }
+    // 低延迟解码: 不做帧重排缓冲；只用切片线程，帧线程每多一个线程就多一帧延迟
+    codecCtx->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    // 允许不完整的访问单元（逐片送入或一帧拆成多包），帧在最后一个宏块行解完时立即输出
+    codecCtx->flags2 |= AV_CODEC_FLAG2_CHUNKS;
+    codecCtx->thread_type = FF_THREAD_SLICE;
+    codecCtx->thread_count = m_decodeThreads;
+
+    // 重新打开时把缓存的参数集（SPS/PPS、VPS）作为 extradata 注入，下一个 IDR 即可出图，
+    // 不必再等编码器在下一个 GOP 重发参数集
+    QByteArray parameterSets;
+    for (const QByteArray& unit : m_parameterSets) {
+        parameterSets += unit;
+    }
+    if (!parameterSets.isEmpty()) {
+        codecCtx->extradata = static_cast<uint8_t*>(av_mallocz(parameterSets.size() + AV_INPUT_BUFFER_PADDING_SIZE));
+        if (codecCtx->extradata) {
+            memcpy(codecCtx->extradata, parameterSets.constData(), parameterSets.size());
+            codecCtx->extradata_size = parameterSets.size();
+        }
+    }
+
+    if (avcodec_open2(codecCtx, codec, nullptr) < 0)
+    {
+        LogWidget::instance()->addLog(QString("Could not open codec"), LogWidget::Error);
+        avcodec_free_context(&codecCtx);
+        return false;
+    }
+    return true;
+}
+
+void VideoDecoderWorker::restartDecoder(const QString& reason)
+{
+    if (codecCtx) {
+        avcodec_free_context(&codecCtx);
+        codecCtx = nullptr;
+    }
+    if (!openDecoder()) {
+        return;
+    }
+    if (m_governor.level() != DecodeGovernor::LevelFull) {
+        applyDecodeLevel(m_governor.level());
+    }
+
+    // 参数集已注入，只需等待下一个 IDR
+    m_isFirstKeyFrameReceived = false;
+    m_sendErrorRun = 0;
+    ++m_decoderRestarts;
+    LogWidget::instance()->addLog(QString("Decoder restarted (%1), cached parameter sets: %2")
+                                      .arg(reason).arg(codecCtx->extradata_size > 0 ? "yes" : "no"),
+                                  LogWidget::Warning);
+}
+
+void VideoDecoderWorker::resetSession()
+{
+    // 网络线程已停止投递，这里排在新会话的第一个包之前；先让其它线程发布完旧会话的帧
+    if (m_mjpegPool) {
+        m_mjpegPool->clear();
+        m_mjpegPool->waitIdle();
+    }
+    waitConvertIdle();
+
+    if (codecCtx) {
+        avcodec_free_context(&codecCtx);
+        codecCtx = nullptr;
+    }
+    m_parameterSets.clear();
+    m_isFirstKeyFrameReceived = false;
+    m_sendErrorRun = 0;
+    m_recoveryPicturesLeft = 0;
+    m_sourceSize = QSize();
+    m_governor.reset();
+    m_swsFlags = SWS_BILINEAR;
+    m_blockHasher.reset();
+    m_lastImage = QImage();
+    if (m_lastFrame) {
+        av_frame_unref(m_lastFrame);
+    }
+
+    m_videoCodec = m_configuredCodec;
+    if (m_videoCodec != VIDEO_CODEC_AUTO && !(m_videoCodec == VIDEO_CODEC_MJPEG && m_mjpegThreads > 1)) {
+        openDecoder();
+    }
+}
+
 VideoDecoderWorker::~VideoDecoderWorker()
 {
     cleanup();
@@ -124,21 +360,95 @@ void VideoDecoderWorker::cleanup()
         m_timer->stop();
     }
 
+    // 先停掉 MJPEG 线程池和转换线程，之后不会再有其它线程向邮箱发布或使用转换上下文
+    m_mjpegPool.reset();
+    stopConvertThread();
+
     if (swsCtx)
     {
         sws_freeContext(swsCtx);
         swsCtx = nullptr;
     }
+    for (SwsContext* ctx : m_sliceSwsCtx)
+    {
+        sws_freeContext(ctx);
+    }
+    m_sliceSwsCtx.clear();
     if (frame)
     {
         av_frame_free(&frame);
         frame = nullptr;
     }
+    av_frame_free(&m_lastFrame);
+    av_frame_free(&m_cropFrame);
+    if (m_packet)
+    {
+        av_packet_free(&m_packet);
+        m_packet = nullptr;
+    }
     if (codecCtx)
     {
         avcodec_free_context(&codecCtx);
         codecCtx = nullptr;
     }
+    m_packetPool.reset();
+}
+
+void VideoDecoderWorker::setTargetSize(const QSize& size)
+{
+    m_targetSize = size;
+}
+
+void VideoDecoderWorker::setVisibleRect(const QRectF& rect)
+{
+    if (rect == m_visibleRect) {
+        return;
+    }
+    m_visibleRect = rect;
+    m_visibleRectDirty = true;
+
+    // 捏合/拖动时每次触摸更新都会调用到这里。重新转换排在已到达的事件之后，
+    // 同一批事件只按最后的区域转换一次
+    if (!m_redrawQueued) {
+        m_redrawQueued = true;
+        QMetaObject::invokeMethod(this, [this]() { redrawVisibleRect(); }, Qt::QueuedConnection);
+    }
+}
+
+void VideoDecoderWorker::redrawVisibleRect()
+{
+    m_redrawQueued = false;
+    // 期间已有新帧按新区域转换过，不必再转
+    if (!m_visibleRectDirty) {
+        return;
+    }
+    m_visibleRectDirty = false;
+
+    // YUV 输出时由渲染器按可见区域采样，不需要重新转换
+    if (m_yuvOutput || !m_lastFrame || !m_lastFrame->data[0]) {
+        return;
+    }
+    qint64 stallNs = 0;
+    dispatchConvert(m_lastFrame, 0, stallNs);
+}
+
+void VideoDecoderWorker::setYuvOutput(bool enabled)
+{
+    if (enabled == m_yuvOutput) {
+        return;
+    }
+    // 显示端切换渲染方式后整帧重绘，块比较从下一帧重新开始；转换线程空闲后才能动它的状态
+    waitConvertIdle();
+    m_blockHasher.reset();
+    m_lastImage = QImage();
+    m_yuvOutput = enabled;
+}
+
+// 与 GLVideoRenderer 的着色器支持的格式一致
+static bool isYuvRenderable(const AVFrame* frame)
+{
+    return frame->format == AV_PIX_FMT_YUV420P || frame->format == AV_PIX_FMT_YUVJ420P
+        || frame->format == AV_PIX_FMT_NV12;
 }
 
 // void VideoDecoderWorker::decodePacket(const QByteArray &packetData)
@@ -171,48 +481,148 @@ void VideoDecoderWorker::cleanup()
 //     //     emit frameDecoded(image);
 //     // }
 // }
+void VideoDecoderWorker::drainPacketQueue()
+{
+    // 一次取空队列；取出期间新到的包也在这里处理，队列再次由空变非空时网络线程会重新投递
+    PacketQueue::Entry entry;
+    while (m_packetQueue->pop(entry)) {
+        // 第一个包或码流换了编码格式时按包的格式（重新）打开解码器
+        if (entry.codec != m_videoCodec) {
+            switchCodec(entry.codec);
+        }
+        // 队列在这个包之前丢弃过参考帧，参考链已断: 清掉解码器内部的参考帧（参数集保留），
+        // 重新等待随机接入点
+        if (entry.discontinuity && codecCtx) {
+            avcodec_flush_buffers(codecCtx);
+            m_isFirstKeyFrameReceived = false;
+        }
+        m_queueLatencyNs = StreamStats::nowNs() - entry.receivedNs;
+        for (const NalUnit& nal : entry.nals) {
+            if (entry.codec == VIDEO_CODEC_H264) {
+                ++m_nalCounts[nal.type];
+            }
+            // 缓存最新的参数集，重启解码器时注入
+            if (isParameterSetUnit(entry.codec, nal.type)) {
+                QByteArray unit = entry.data.mid(nal.offset, nal.size);
+                m_parameterSets[nal.type] = usesStartCodes(entry.codec) ? QByteArray("\x00\x00\x00\x01", 4) + unit : unit;
+            }
+        }
+        if (entry.codec == VIDEO_CODEC_MJPEG && m_mjpegThreads > 1) {
+            submitMjpegFrame(entry.data, entry.receivedNs);
+        } else {
+            decodePacket(entry.data, entry.receivedNs, entry.info);
+        }
+        entry.data.clear();
+    }
+}
+
+void VideoDecoderWorker::submitMjpegFrame(const QByteArray& packetData, qint64 receivedNs)
+{
+    if (!m_mjpegPool) {
+        // 各线程按到达序号排序后发布，邮箱仍只有这一个发布者（发布在线程池的排序锁内串行进行）
+        m_mjpegPool.reset(new MjpegDecodePool(m_mjpegThreads, m_mjpegThreads * MJPEG_PENDING_PER_THREAD,
+                                              m_imageFormat, m_swsFormat,
+                                              [this](const VideoFrame& decoded) {
+            if (m_mailbox->publish(decoded)) {
+                emit frameAvailable();
+            }
+        }, m_memoryBudget));
+    }
+    m_mjpegPool->submit(packetData, receivedNs, m_targetSize, m_visibleRect);
+    updateMemoryUsage();
+    if (++m_statsPackets >= DECODER_STATS_INTERVAL) {
+        m_statsPackets = 0;
+        reportMjpegStats();
+    }
+}
+
+void VideoDecoderWorker::reportMjpegStats()
+{
+    StreamStats* stats = StreamStats::instance();
+    stats->setValue("decoder.codec", videoCodecName(m_videoCodec));
+    stats->setValue("mjpeg.threads", m_mjpegPool->threadCount());
+    stats->setValue("mjpeg.decoded", m_mjpegPool->decodedCount());
+    stats->setValue("mjpeg.dropped", m_mjpegPool->droppedCount());
+    stats->setValue("mjpeg.failed", m_mjpegPool->failedCount());
+    stats->setValue("mjpeg.reordered", m_mjpegPool->reorderedCount());
+    stats->setValue("mjpeg.decodeUs", m_mjpegPool->averageDecodeNs() / 1000);
+    stats->setValue("mjpeg.framePoolMisses", m_mjpegPool->framePool().misses());
+    if (m_memoryBudget) {
+        m_memoryBudget->report();
+    }
+    stats->setValue("queue.depth", m_packetQueue->depth());
+    stats->setValue("queue.latencyUs", m_queueLatencyNs / 1000);
+    stats->setValue("display.published", m_mailbox->publishedCount());
+    stats->setValue("display.dropped", m_mailbox->droppedCount());
+    stats->reportIfDue();
+}
+
 void VideoDecoderWorker::decodePacket(const QByteArray& packetData)
+{
+    decodePacket(packetData, StreamStats::nowNs(),
+                 parseH264Packet(reinterpret_cast<const uint8_t*>(packetData.constData()), packetData.size()));
+}
+
+void VideoDecoderWorker::decodePacket(const QByteArray& packetData, qint64 receivedNs, const PacketInfo& info)
 {
     QElapsedTimer timer;
     timer.start(); // 开始计时
 
-    // 如果还没收到过第一个关键帧，手动检查当前包是不是关键帧
+    // 如果还没收到过第一个关键帧，检查当前包是不是关键帧
     if (!m_isFirstKeyFrameReceived) {
-        if (isH264KeyFrame(packetData)) {
+        if (isRandomAccessPoint(info)) {
             m_isFirstKeyFrameReceived = true;
-            LogWidget::instance()->addLog("Received First Key Frame (IDR/SPS)!", LogWidget::Info);
+            // 帧内刷新码流没有 IDR，从恢复点开始解码，刷新完成前的画面不完整，不显示
+            if (info.hasRecoveryPoint && !(info.hasIdr && info.startsPicture)) {
+                m_recoveryPicturesLeft = info.recoveryFrameCnt;
+                ++m_recoveryStarts;
+                LogWidget::instance()->addLog(QString("Started at recovery point SEI, hiding %1 frames")
+                                                  .arg(m_recoveryPicturesLeft), LogWidget::Info);
+            } else {
+                m_recoveryPicturesLeft = 0;
+                LogWidget::instance()->addLog("Received First Key Frame (IDR/SPS)!", LogWidget::Info);
+            }
         } else {
             // 如果不是关键帧，直接丢弃，防止绿屏
             return;
         }
     }
 
-    // 将 packetData 拷贝到 AVPacket
-    AVPacket* pkt = av_packet_alloc();
-    if (!pkt) {
-        LogWidget::instance()->addLog(QString("Could not allocate AVPacket"), LogWidget::Warning);
+    if (!codecCtx || !m_packet) {
         return;
     }
-    // pkt->data = reinterpret_cast<uint8_t*>(const_cast<char*>(packetData.data()));
-    // pkt->size = packetData.size();
-    if (av_new_packet(pkt, packetData.size()) == 0) {
-        memcpy(pkt->data, packetData.constData(), packetData.size());
-    } else {
-        av_packet_free(&pkt);
+
+    // 将 packetData 拷贝到池化的带填充缓冲区，复用同一个 AVPacket
+    if (!m_packetPool.fill(m_packet, reinterpret_cast<const uint8_t*>(packetData.constData()), packetData.size())) {
+        LogWidget::instance()->addLog(QString("Could not fill AVPacket, size: %1").arg(packetData.size()), LogWidget::Warning);
         return;
     }
+    int ret = avcodec_send_packet(codecCtx, m_packet);
+
+    // 解码器内部已持有自己的引用，这里释放后缓冲区即可回池
+    av_packet_unref(m_packet);
+    ++m_packetCount;
 
-    int ret = avcodec_send_packet(codecCtx, pkt);
     if (ret < 0) {
-        char errbuf[AV_ERROR_MAX_STRING_SIZE];
-        av_strerror(ret, errbuf, sizeof(errbuf));
-        // 不是完整帧的话 这边的会报错， 暂时先去掉日志
-        // LogWidget::instance()->addLog(QString("Error sending packet for decoding: %1").arg(errbuf), LogWidget::Warning);
-        av_packet_free(&pkt);
+        // 访问单元已由 AccessUnitAssembler 组装，这里的错误是真正的码流错误，计数后汇总输出
+        ++m_sendErrors;
+        // 连续出错说明解码器状态已损坏，重新打开并注入缓存的参数集
+        if (++m_sendErrorRun >= MAX_SEND_ERROR_RUN) {
+            restartDecoder(QString("%1 consecutive send errors").arg(m_sendErrorRun));
+        }
         return;
     }
+    m_sendErrorRun = 0;
+
+    // 恢复点之后的前 recovery_frame_cnt 幅画面仍在刷新中，解码但不显示
+    // 低延迟模式下每幅输入画面对应一帧输出，按画面首片计数
+    bool hideOutput = m_recoveryPicturesLeft > 0;
+    if (hideOutput && info.hasVcl && info.startsPicture) {
+        --m_recoveryPicturesLeft;
+    }
 
     // 尝试接收所有解码出的帧
+    qint64 stallNs = 0;
     while (true) {
         ret = avcodec_receive_frame(codecCtx, frame);
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
@@ -222,6 +632,11 @@ void VideoDecoderWorker::decodePacket(const QByteArray& packetData)
             LogWidget::instance()->addLog(QString("Error during decoding"), LogWidget::Warning);
             break;
         }
+        if (hideOutput) {
+            ++m_hiddenFrames;
+            av_frame_unref(frame);
+            continue;
+        }
         // 得到解码帧（YUV420P）
 
         // // 初始化转换上下文（如果还没创建）
@@ -230,50 +645,588 @@ void VideoDecoderWorker::decodePacket(const QByteArray& packetData)
         //                             frame->width, frame->height, AV_PIX_FMT_RGBA,
         //                             SWS_BILINEAR, nullptr, nullptr, nullptr);
         // }
-        // 初始化转换上下文（如果还没创建）
-        if (!swsCtx) {
-            // 将 SWS_BILINEAR 改为 SWS_POINT
-            // 将 SWS_POINT 改为 SWS_FAST_BILINEAR 消除锯齿
-            swsCtx = sws_getContext(frame->width, frame->height, codecCtx->pix_fmt,
-                                    frame->width, frame->height, AV_PIX_FMT_RGBA,
-                                    SWS_BILINEAR, nullptr, nullptr, nullptr);
-        }
-
-        // 计算目标缓冲区大小
-        int numBytes = av_image_get_buffer_size(AV_PIX_FMT_RGBA, frame->width, frame->height, 1);
-        QByteArray imgBuffer(numBytes, 0);
-
-        uint8_t* destData[4] = {
-            reinterpret_cast<uint8_t*>(imgBuffer.data()),
-            nullptr, nullptr, nullptr
-        };
-        int destLinesize[4] = { 4 * frame->width, 0, 0, 0 };
-
-        // 转换为 RGBA
-        sws_scale(swsCtx, frame->data, frame->linesize, 0, frame->height,
-                  destData, destLinesize);
-
-        // 构造 QImage
-        QImage image(reinterpret_cast<const uchar*>(imgBuffer.constData()),
-                     frame->width, frame->height, QImage::Format_RGBA8888);
-        // 复制一份，防止堆外数据被复用
-        QImage finalImage = image.copy();
+        QSize sourceSize(frame->width, frame->height);
+        // 分辨率随新的 SPS 变化时，sws_getCachedContext 和 FramePool 都会按新尺寸重建
+        if (sourceSize != m_sourceSize) {
+            if (m_sourceSize.isValid()) {
+                LogWidget::instance()->addLog(QString("Stream resolution changed: %1x%2 -> %3x%4")
+                                                  .arg(m_sourceSize.width()).arg(m_sourceSize.height())
+                                                  .arg(sourceSize.width()).arg(sourceSize.height()),
+                                              LogWidget::Info);
+            }
+            m_sourceSize = sourceSize;
+        }
 
-        // 发射信号，通知外部有帧已解码
-        emit frameDecoded(finalImage);
+        // OpenGL 渲染时跳过 CPU 色彩转换和缩放，解码器的帧缓冲由邮箱和渲染器的引用保持
+        if (m_yuvOutput && isYuvRenderable(frame)) {
+            publishYuvFrame(frame, receivedNs);
+            av_frame_unref(frame);
+            continue;
+        }
+
+        // 只增加引用计数，不拷贝像素
+        if (m_lastFrame) {
+            av_frame_unref(m_lastFrame);
+            av_frame_ref(m_lastFrame, frame);
+        }
+
+        bool dispatched = dispatchConvert(frame, receivedNs, stallNs);
+        av_frame_unref(frame);
+        if (!dispatched) {
+            break;
+        }
     }
 
-    av_packet_free(&pkt);
+    // 解码线程在本包上的总耗时与帧间隔比较，必要时调整解码质量
+    // 拆分拓扑下也包含等待转换队列的时间，转换跟不上时同样需要降级（最后一级即更快的缩放算法）
+    qint64 elapsedNs = timer.nsecsElapsed();
+    if (m_governor.update(receivedNs, elapsedNs)) {
+        applyDecodeLevel(m_governor.level());
+    }
+    m_decodeStage.addBusy(elapsedNs - stallNs);
+    m_decodeStage.addStall(stallNs);
+    m_decodeStage.report();
 
     // --- 添加日志 ---
-    // 在解码完成并发射信号前（emit frameDecoded(image) 之前）
-    LogWidget::instance()->addLog(
-        QString("[Android-Decoder] RecvSize: %1, DecodeCost: %2 ms, QueueSize: %3")
-            .arg(packetData.size())
-            .arg(timer.elapsed())
-            .arg(m_queue.size()), // 监控队列是否积压
-        LogWidget::Info
-        );
+    // 每包写日志开销太大，改为累计在成员里，每 DECODER_STATS_INTERVAL 个包汇总一次到 StreamStats
+    m_lastPacketBytes = packetData.size();
+    m_lastDecodeNs = elapsedNs;
+    if (m_memoryBudget) {
+        updateMemoryUsage();
+    }
+    if (++m_statsPackets >= DECODER_STATS_INTERVAL) {
+        m_statsPackets = 0;
+        reportDecoderStats();
+    }
+}
+
+void VideoDecoderWorker::reportDecoderStats()
+{
+    StreamStats* stats = StreamStats::instance();
+    stats->setValue("decoder.lastPacketBytes", m_lastPacketBytes);
+    stats->setValue("decoder.lastDecodeMs", m_lastDecodeNs / 1000000);
+    stats->setValue("decoder.packets", m_packetCount);
+    stats->setValue("decoder.sendErrors", m_sendErrors);
+    stats->setValue("decoder.packetPoolBytes", m_packetPool.bufferSize());
+    stats->setValue("decoder.packetPoolRegrows", m_packetPool.regrowCount());
+    stats->setValue("decoder.framePoolHits", m_framePool.hits());
+    stats->setValue("decoder.framePoolMisses", m_framePool.misses());
+    stats->setValue("decoder.codec", videoCodecName(m_videoCodec));
+    stats->setValue("decoder.restarts", m_decoderRestarts);
+    stats->setValue("decoder.recoveryStarts", m_recoveryStarts);
+    stats->setValue("decoder.hiddenFrames", m_hiddenFrames);
+    stats->setValue("decoder.level", DecodeGovernor::levelName(m_governor.level()));
+    stats->setValue("decoder.levelChanges", m_governor.changeCount());
+    stats->setValue("decoder.busyUs", m_governor.busyNs() / 1000);
+    stats->setValue("decoder.frameIntervalUs", m_governor.frameIntervalNs() / 1000);
+    stats->setValue("stream.idrSlices", m_nalCounts[H264_NAL_IDR_SLICE]);
+    stats->setValue("stream.slices", m_nalCounts[H264_NAL_SLICE]);
+    stats->setValue("stream.sei", m_nalCounts[H264_NAL_SEI]);
+    stats->setValue("stream.sps", m_nalCounts[H264_NAL_SPS]);
+    stats->setValue("queue.depth", m_packetQueue->depth());
+    stats->setValue("queue.dropped", m_packetQueue->droppedCount());
+    stats->setValue("queue.idrSkips", m_packetQueue->idrSkipCount());
+    stats->setValue("queue.latencyUs", m_queueLatencyNs / 1000);
+    stats->setValue("display.published", m_mailbox->publishedCount());
+    stats->setValue("display.dropped", m_mailbox->droppedCount());
+    if (m_convertQueue) {
+        stats->setValue("stage.convert.queue", m_convertQueue->size());
+    } else {
+        reportConvertStats();
+    }
+    if (m_memoryBudget) {
+        m_memoryBudget->report();
+    }
+    stats->reportIfDue();
+}
+
+bool VideoDecoderWorker::dispatchConvert(const AVFrame* frame, qint64 receivedNs, qint64& stallNs)
+{
+    m_visibleRectDirty = false;
+
+    // 拆分拓扑下把帧引用交给转换线程，本线程接着解码下一包；转换队列满时在这里等待（反压）
+    if (m_convertThread) {
+        ConvertJob job;
+        job.frame = av_frame_clone(frame);
+        job.targetSize = m_targetSize;
+        job.visibleRect = m_visibleRect;
+        job.swsFlags = m_swsFlags;
+        job.receivedNs = receivedNs;
+        if (!job.frame) {
+            return false;
+        }
+        qint64 stallStart = StreamStats::nowNs();
+        m_convertFree.acquire();
+        stallNs += StreamStats::nowNs() - stallStart;
+        m_convertQueue->push(job);
+        m_convertItems.release();
+        return true;
+    }
+
+    return convertAndPublish(frame, m_targetSize, m_visibleRect, m_swsFlags, receivedNs);
+}
+
+bool VideoDecoderWorker::convertAndPublish(const AVFrame* frame, const QSize& targetSize, const QRectF& visibleRect,
+                                           int swsFlags, qint64 receivedNs)
+{
+    // 目标尺寸与 VideoWidget::paintEvent 的显示区域一致，GUI 线程只需 1:1 贴图
+    QSize sourceSize(frame->width, frame->height);
+    QSize outSize = deskLetterboxRect(targetSize, sourceSize).size();
+    if (outSize.isEmpty()) {
+        outSize = sourceSize;
+    }
+
+    // 放大时只转换可见区域，显示区域对应的是这一块；倍数高到可见区域比显示区域还小时按原尺寸转换，
+    // 由 VideoWidget 放大，转换量随倍数下降而不是维持在显示尺寸
+    QRect crop = m_cropFrame ? deskVisibleSourceRect(visibleRect, sourceSize) : QRect(QPoint(0, 0), sourceSize);
+    bool cropped = crop.size() != sourceSize;
+    if (cropped) {
+        outSize = outSize.boundedTo(crop.size());
+    }
+
+    // 没有空闲缓冲区可复用、再分配会超出预算时丢帧，显示端保留上一帧，释放后再恢复
+    if (m_memoryBudget) {
+        qint64 cost = m_framePool.acquireCost(outSize.width(), outSize.height(), m_imageFormat);
+        if (cost > 0 && !m_memoryBudget->withinLimit(MemoryBudget::BudgetFramePool, cost)) {
+            m_memoryBudget->countOverrun(MemoryBudget::BudgetFramePool);
+            return true;
+        }
+    }
+
+    // 与上一次发布的帧逐块比较；输出尺寸或格式变了（缩放目标变化）时上一帧不能复用，整帧转换
+    QRegion dirty;
+    bool partial = false;
+    if (m_changeDetection && BlockHasher::supports(frame)) {
+        qint64 hashStart = StreamStats::nowNs();
+        int changedBlocks = m_blockHasher.update(frame);
+        m_hashNs += StreamStats::nowNs() - hashStart;
+        ++m_changeFrames;
+
+        qint64 pixels = static_cast<qint64>(sourceSize.width()) * sourceSize.height();
+        m_changePixels += pixels;
+        bool reusable = m_lastImage.size() == outSize && m_lastImage.format() == m_imageFormat && m_lastCrop == crop;
+        if (reusable && changedBlocks == 0) {
+            // 画面完全没变: 不转换、不发布，显示端也不重绘
+            ++m_identicalFrames;
+            m_skippedPixels += pixels;
+            return true;
+        }
+        if (reusable && changedBlocks < m_blockHasher.blockCount()) {
+            dirty = changedRegion(crop, outSize);
+            if (dirty.isEmpty()) {
+                // 变化都在可见区域之外
+                ++m_identicalFrames;
+                m_skippedPixels += pixels;
+                return true;
+            }
+            // 缩放输出的每个像素依赖周围多个源像素，按块转换只在 1:1 且未裁剪时做；
+            // 未变化块要从上一帧拷贝，变化多时不如 SIMD 整帧转换
+            partial = !cropped && outSize == sourceSize && YuvConverter::supports(frame, m_swsFormat)
+                      && m_blockHasher.changedPixels() * 100 <= pixels * PARTIAL_CONVERT_MAX_PERCENT;
+            if (partial) {
+                m_skippedPixels += pixels - m_blockHasher.changedPixels();
+            }
+        }
+    }
+
+    // 从缓冲池取输出帧，sws_scale 直接写入，不再清零和二次拷贝
+    QImage image = m_framePool.acquire(outSize.width(), outSize.height(), m_imageFormat);
+    if (image.isNull()) {
+        LogWidget::instance()->addLog(QString("Could not acquire output frame"), LogWidget::Warning);
+        m_blockHasher.reset();
+        return false;
+    }
+
+    // 可见区域做成引用原帧缓冲的裁剪视图，后面的转换路径（SIMD 内核、切片、sws_scale）都只看到这一块
+    const AVFrame* source = frame;
+    if (cropped) {
+        av_frame_unref(m_cropFrame);
+        if (av_frame_ref(m_cropFrame, frame) >= 0) {
+            m_cropFrame->crop_left = crop.x();
+            m_cropFrame->crop_top = crop.y();
+            m_cropFrame->crop_right = sourceSize.width() - crop.x() - crop.width();
+            m_cropFrame->crop_bottom = sourceSize.height() - crop.y() - crop.height();
+            if (av_frame_apply_cropping(m_cropFrame, AV_FRAME_CROP_UNALIGNED) >= 0) {
+                source = m_cropFrame;
+            }
+        }
+    }
+    if (cropped && source == frame) {
+        LogWidget::instance()->addLog(QString("Could not crop frame to the visible rect"), LogWidget::Warning);
+        av_frame_unref(m_cropFrame);
+        m_blockHasher.reset();
+        return false;
+    }
+
+    // 转换为绘制引擎的原生格式
+    bool converted = true;
+    if (partial) {
+        convertChangedBlocks(frame, image);
+    } else {
+        converted = convertFrame(source, image, swsFlags);
+    }
+    if (cropped) {
+        av_frame_unref(m_cropFrame);
+    }
+    if (!converted) {
+        LogWidget::instance()->addLog(QString("Could not create SwsContext"), LogWidget::Warning);
+        m_blockHasher.reset();
+        return false;
+    }
+    if (m_changeDetection) {
+        m_lastImage = image;
+        m_lastCrop = crop;
+    }
+
+    // 发布到邮箱，覆盖尚未显示的旧帧；UI 未被通知过时才发信号
+    // QImage 引用池内缓冲区，最后一个持有者释放后自动回池
+    VideoFrame decoded;
+    decoded.image = image;
+    decoded.sourceSize = sourceSize;
+    decoded.dirty = dirty;
+    decoded.visibleRect = deskNormalizedRect(crop, sourceSize);
+    decoded.receivedNs = receivedNs;
+    decoded.decodedNs = StreamStats::nowNs();
+    if (m_mailbox->publish(decoded)) {
+        emit frameAvailable();
+    }
+    return true;
+}
+
+void VideoDecoderWorker::convertChangedBlocks(const AVFrame* frame, QImage& image)
+{
+    QElapsedTimer convertTimer;
+    convertTimer.start();
+
+    const int block = BlockHasher::BLOCK_SIZE;
+    bool nv12 = frame->format == AV_PIX_FMT_NV12;
+    bool rgb565 = m_swsFormat == AV_PIX_FMT_RGB565LE;
+    int bytesPerPixel = image.depth() / 8;
+    uint8_t* dst = image.bits();
+    int dstStride = image.bytesPerLine();
+    const uint8_t* previous = m_lastImage.constBits();
+    int previousStride = m_lastImage.bytesPerLine();
+    int columns = m_blockHasher.columns();
+
+    // 每个块行内把相邻的变化/未变化块合并成一段，变化段交给 SIMD 内核，未变化段逐行拷贝
+    auto convertBlockRow = [&](int by) {
+        int rowBegin = by * block;
+        int rowEnd = qMin(rowBegin + block, frame->height);
+        int bx = 0;
+        while (bx < columns) {
+            bool changed = m_blockHasher.isChanged(bx, by);
+            int end = bx + 1;
+            while (end < columns && m_blockHasher.isChanged(end, by) == changed) {
+                ++end;
+            }
+            int x = bx * block;
+            int width = qMin(end * block, frame->width) - x;
+            if (changed) {
+                m_yuvConverter.convertRows(frame->data[0] + x, frame->linesize[0],
+                                           frame->data[1] + (nv12 ? x : x / 2), frame->linesize[1],
+                                           nv12 ? nullptr : frame->data[2] + x / 2, nv12 ? 0 : frame->linesize[2], nv12,
+                                           dst + x * bytesPerPixel, dstStride, rgb565, width, rowBegin, rowEnd);
+            } else {
+                for (int row = rowBegin; row < rowEnd; ++row) {
+                    memcpy(dst + static_cast<ptrdiff_t>(row) * dstStride + x * bytesPerPixel,
+                           previous + static_cast<ptrdiff_t>(row) * previousStride + x * bytesPerPixel,
+                           width * bytesPerPixel);
+                }
+            }
+            bx = end;
+        }
+    };
+
+    if (m_slicePool) {
+        m_slicePool->run(m_blockHasher.rows(), convertBlockRow);
+    } else {
+        for (int by = 0; by < m_blockHasher.rows(); ++by) {
+            convertBlockRow(by);
+        }
+    }
+
+    m_convertNs[ConvertYuv] += convertTimer.nsecsElapsed();
+    ++m_convertCount[ConvertYuv];
+}
+
+QRegion VideoDecoderWorker::changedRegion(const QRect& crop, const QSize& outSize) const
+{
+    const int block = BlockHasher::BLOCK_SIZE;
+    bool scaled = outSize != crop.size();
+    qreal scaleX = qreal(outSize.width()) / crop.width();
+    qreal scaleY = qreal(outSize.height()) / crop.height();
+    QRect bounds(QPoint(0, 0), outSize);
+
+    QRegion region;
+    for (int by = 0; by < m_blockHasher.rows(); ++by) {
+        int bx = 0;
+        while (bx < m_blockHasher.columns()) {
+            if (!m_blockHasher.isChanged(bx, by)) {
+                ++bx;
+                continue;
+            }
+            int end = bx + 1;
+            while (end < m_blockHasher.columns() && m_blockHasher.isChanged(end, by)) {
+                ++end;
+            }
+            QRect rect = QRect(bx * block, by * block, (end - bx) * block, block) & crop;
+            bx = end;
+            if (rect.isEmpty()) {
+                continue;
+            }
+            rect.translate(-crop.topLeft());
+            if (scaled) {
+                rect = QRect(QPoint(qFloor(rect.left() * scaleX) - 1, qFloor(rect.top() * scaleY) - 1),
+                             QPoint(qCeil((rect.right() + 1) * scaleX), qCeil((rect.bottom() + 1) * scaleY)));
+            }
+            region += rect & bounds;
+        }
+    }
+    return region;
+}
+
+void VideoDecoderWorker::publishYuvFrame(const AVFrame* frame, qint64 receivedNs)
+{
+    AVFrame* ref = av_frame_clone(frame);
+    if (!ref) {
+        return;
+    }
+    VideoFrame decoded;
+    decoded.yuv.reset(ref, [](AVFrame* f) { av_frame_free(&f); });
+    decoded.sourceSize = QSize(frame->width, frame->height);
+    decoded.receivedNs = receivedNs;
+    decoded.decodedNs = StreamStats::nowNs();
+    if (m_mailbox->publish(decoded)) {
+        emit frameAvailable();
+    }
+}
+
+// 只在解码线程调用，m_mjpegPool 由解码线程创建和释放
+void VideoDecoderWorker::updateMemoryUsage()
+{
+    if (!m_memoryBudget) {
+        return;
+    }
+    qint64 bytes = m_framePool.allocatedBytes();
+    if (m_mjpegPool) {
+        bytes += m_mjpegPool->framePool().allocatedBytes();
+    }
+    m_memoryBudget->setUsage(MemoryBudget::BudgetFramePool, bytes);
+}
+
+void VideoDecoderWorker::reportConvertStats()
+{
+    StreamStats* stats = StreamStats::instance();
+    if (m_changeFrames > 0) {
+        stats->setValue("change.kernel", BlockHasher::kernelName(m_blockHasher.kernel()));
+        stats->setValue("change.hashUs", m_hashNs / 1000 / m_changeFrames);
+        stats->setValue("change.identicalFrames", m_identicalFrames);
+        stats->setValue("change.skippedPct", m_changePixels > 0 ? m_skippedPixels * 100 / m_changePixels : 0);
+    }
+    if (m_convertCount[ConvertYuv] > 0) {
+        stats->setValue(QString("decoder.convertUs.%1").arg(YuvConverter::kernelName(m_yuvConverter.kernel())),
+                        m_convertNs[ConvertYuv] / 1000 / m_convertCount[ConvertYuv]);
+    }
+    if (m_convertCount[ConvertSws] > 0) {
+        stats->setValue("decoder.convertUs.sws", m_convertNs[ConvertSws] / 1000 / m_convertCount[ConvertSws]);
+    }
+}
+
+void VideoDecoderWorker::startConvertThread()
+{
+    m_convertQueue.reset(new SpscQueue<ConvertJob>(CONVERT_QUEUE_SIZE));
+    m_convertFree.release(m_convertQueue->capacity());
+    m_convertQuit = false;
+    m_convertThread = QThread::create([this]() {
+        convertLoop();
+    });
+    m_convertThread->setObjectName("ConvertStage");
+    m_convertThread->start();
+}
+
+void VideoDecoderWorker::stopConvertThread()
+{
+    if (!m_convertThread) {
+        return;
+    }
+    m_convertQuit = true;
+    m_convertItems.release();
+    m_convertThread->wait();
+    delete m_convertThread;
+    m_convertThread = nullptr;
+
+    // 释放转换线程退出时尚未处理的帧引用
+    ConvertJob job;
+    while (m_convertQueue->pop(job)) {
+        av_frame_free(&job.frame);
+    }
+    m_convertQueue.reset();
+    m_convertFree.acquire(m_convertFree.available());
+    m_convertItems.acquire(m_convertItems.available());
+}
+
+void VideoDecoderWorker::waitConvertIdle()
+{
+    if (!m_convertThread) {
+        return;
+    }
+    // 转换线程在帧发布完成后才归还空位，拿到全部空位即说明队列已清空
+    int capacity = m_convertQueue->capacity();
+    m_convertFree.acquire(capacity);
+    m_convertFree.release(capacity);
+}
+
+void VideoDecoderWorker::convertLoop()
+{
+    applyThreadPolicy("convert", m_convertPolicy);
+    StageMeter meter("convert");
+    int statsFrames = 0;
+    forever {
+        m_convertItems.acquire();
+        // 停止时剩余的帧由 stopConvertThread 释放
+        ConvertJob job;
+        if (m_convertQuit || !m_convertQueue->pop(job)) {
+            return;
+        }
+
+        qint64 startNs = StreamStats::nowNs();
+        convertAndPublish(job.frame, job.targetSize, job.visibleRect, job.swsFlags, job.receivedNs);
+        av_frame_free(&job.frame);
+        meter.addBusy(StreamStats::nowNs() - startNs);
+        m_convertFree.release();
+
+        meter.report();
+        if (++statsFrames >= DECODER_STATS_INTERVAL) {
+            statsFrames = 0;
+            reportConvertStats();
+        }
+    }
+}
+
+void VideoDecoderWorker::applyDecodeLevel(DecodeGovernor::Level level)
+{
+    // 各级别累加生效；这几个字段 libavcodec 在每帧解码时读取，无需重新打开解码器
+    codecCtx->skip_loop_filter = level >= DecodeGovernor::LevelSkipLoopFilter ? AVDISCARD_ALL : AVDISCARD_DEFAULT;
+    codecCtx->skip_frame = level >= DecodeGovernor::LevelSkipNonRef ? AVDISCARD_NONREF : AVDISCARD_DEFAULT;
+    if (level >= DecodeGovernor::LevelFast) {
+        codecCtx->flags2 |= AV_CODEC_FLAG2_FAST;
+    } else {
+        codecCtx->flags2 &= ~AV_CODEC_FLAG2_FAST;
+    }
+    m_swsFlags = level >= DecodeGovernor::LevelFastScaler ? SWS_FAST_BILINEAR : SWS_BILINEAR;
+
+    LogWidget::instance()->addLog(QString("Decode quality -> %1 (busy %2 us / interval %3 us)")
+                                      .arg(DecodeGovernor::levelName(level))
+                                      .arg(m_governor.busyNs() / 1000)
+                                      .arg(m_governor.frameIntervalNs() / 1000), LogWidget::Info);
+}
+
+bool VideoDecoderWorker::convertFrame(const AVFrame* frame, QImage& image, int swsFlags)
+{
+    QElapsedTimer convertTimer;
+    convertTimer.start();
+
+    // 同尺寸转换不需要缩放器，YUV420P/NV12 直接走 SIMD 专用内核
+    bool sameSize = image.size() == QSize(frame->width, frame->height);
+    bool useYuvKernel = sameSize && YuvConverter::supports(frame, m_swsFormat);
+    ConvertPath path = useYuvKernel ? ConvertYuv : ConvertSws;
+
+    // 切片之间互不依赖的情况（不缩放）才分给多个核心并行
+    if (sameSize && m_slicePool) {
+        if (!convertSlices(frame, image, useYuvKernel, swsFlags)) {
+            return false;
+        }
+        m_convertNs[path] += convertTimer.nsecsElapsed();
+        ++m_convertCount[path];
+        return true;
+    }
+
+    if (useYuvKernel)
+    {
+        m_yuvConverter.convert(frame, m_swsFormat, image.bits(), image.bytesPerLine(), 0, frame->height);
+        m_convertNs[path] += convertTimer.nsecsElapsed();
+        ++m_convertCount[path];
+        return true;
+    }
+
+    // 转换和缩放合并为一次 sws_scale；源/目标尺寸或格式变化时才重建上下文
+    // 将 SWS_BILINEAR 改为 SWS_POINT
+    // 将 SWS_POINT 改为 SWS_FAST_BILINEAR 消除锯齿
+    swsCtx = sws_getCachedContext(swsCtx,
+                                  frame->width, frame->height, static_cast<AVPixelFormat>(frame->format),
+                                  image.width(), image.height(), m_swsFormat,
+                                  swsFlags, nullptr, nullptr, nullptr);
+    if (!swsCtx)
+    {
+        return false;
+    }
+
+    uint8_t* destData[4] = { image.bits(), nullptr, nullptr, nullptr };
+    int destLinesize[4] = { static_cast<int>(image.bytesPerLine()), 0, 0, 0 };
+    sws_scale(swsCtx, frame->data, frame->linesize, 0, frame->height,
+              destData, destLinesize);
+
+    m_convertNs[path] += convertTimer.nsecsElapsed();
+    ++m_convertCount[path];
+    return true;
+}
+
+bool VideoDecoderWorker::convertSlices(const AVFrame* frame, QImage& image, bool useYuvKernel, int swsFlags)
+{
+    const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(static_cast<AVPixelFormat>(frame->format));
+    if (!desc) {
+        return false;
+    }
+
+    // 切片行数对齐到色度垂直采样，保证每个切片的色度行起点完整
+    int rowAlign = 1 << desc->log2_chroma_h;
+    int sliceCount = m_slicePool->maxThreads() * SLICES_PER_THREAD;
+    int sliceRows = (frame->height + sliceCount - 1) / sliceCount;
+    sliceRows = (sliceRows + rowAlign - 1) / rowAlign * rowAlign;
+    sliceCount = (frame->height + sliceRows - 1) / sliceRows;
+
+    uint8_t* dst = image.bits();
+    int dstStride = image.bytesPerLine();
+
+    if (useYuvKernel) {
+        m_slicePool->run(sliceCount, [&](int slice) {
+            int rowBegin = slice * sliceRows;
+            int rowEnd = qMin(rowBegin + sliceRows, frame->height);
+            m_yuvConverter.convert(frame, m_swsFormat, dst, dstStride, rowBegin, rowEnd);
+        });
+        return true;
+    }
+
+    // 每个切片当作一帧独立转换，SwsContext 不能跨线程共用
+    if (m_sliceSwsCtx.size() < sliceCount) {
+        m_sliceSwsCtx.resize(sliceCount);
+    }
+
+    std::atomic<bool> ok{true};
+    m_slicePool->run(sliceCount, [&](int slice) {
+        int rowBegin = slice * sliceRows;
+        int rows = qMin(sliceRows, frame->height - rowBegin);
+
+        SwsContext*& ctx = m_sliceSwsCtx[slice];
+        ctx = sws_getCachedContext(ctx,
+                                   frame->width, rows, static_cast<AVPixelFormat>(frame->format),
+                                   frame->width, rows, m_swsFormat,
+                                   swsFlags, nullptr, nullptr, nullptr);
+        if (!ctx) {
+            ok = false;
+            return;
+        }
+
+        const uint8_t* srcData[4] = { nullptr, nullptr, nullptr, nullptr };
+        for (int plane = 0; plane < 4 && frame->data[plane]; ++plane) {
+            int shift = (plane == 1 || plane == 2) ? desc->log2_chroma_h : 0;
+            srcData[plane] = frame->data[plane] + (rowBegin >> shift) * frame->linesize[plane];
+        }
+        uint8_t* destData[4] = { dst + rowBegin * dstStride, nullptr, nullptr, nullptr };
+        int destLinesize[4] = { dstStride, 0, 0, 0 };
+        sws_scale(ctx, srcData, frame->linesize, 0, rows, destData, destLinesize);
+    });
+    return ok;
 }
 
 void VideoDecoderWorker::decodePacket1(const QByteArray& packetData)
@@ -314,12 +1267,13 @@ void VideoDecoderWorker::decodePacket1(const QByteArray& packetData)
         }
         // 得到解码帧（YUV420P）
 
-        // 初始化转换上下文（如果还没创建）
+        // 初始化转换上下文，分辨率变化时重建
+        swsCtx = sws_getCachedContext(swsCtx, frame->width, frame->height, codecCtx->pix_fmt,
+                                      frame->width, frame->height, AV_PIX_FMT_RGBA,
+                                      SWS_BILINEAR, nullptr, nullptr, nullptr);
         if (!swsCtx)
         {
-            swsCtx = sws_getContext(frame->width, frame->height, codecCtx->pix_fmt,
-                                    frame->width, frame->height, AV_PIX_FMT_RGBA,
-                                    SWS_BILINEAR, nullptr, nullptr, nullptr);
+            break;
         }
 
         QImage image(frame->width, frame->height, QImage::Format_RGBA8888);
@@ -361,7 +1315,12 @@ void VideoDecoderWorker::decodePacket1(const QByteArray& packetData)
         // LogWidget::instance()->addLog(QString("VideoDecoderWorker Decoder QImage Took %1 ms").arg(timer.elapsed()), LogWidget::Info);
 
         // 发射信号，通知外部有帧已解码
-        emit frameDecoded(image);
+        VideoFrame decoded;
+        decoded.image = image;
+        decoded.sourceSize = image.size();
+        if (m_mailbox->publish(decoded)) {
+            emit frameAvailable();
+        }
     }
 
     av_packet_free(&pkt);
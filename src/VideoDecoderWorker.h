@@ -4,43 +4,236 @@
 #include <QObject>
 #include <QByteArray>
 #include <QImage>
+#include <QMap>
 
 // FFmpeg 相关头文件
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
+#include <libavutil/pixdesc.h>
 #include <libswscale/swscale.h>
 }
 
-#include <QQueue>
 #include <QMutex>
+#include <QSemaphore>
+#include <QThread>
 #include <QTimer>
 
+#include "PacketPool.h"
+#include "FramePool.h"
+#include "DeskDefine.h"
+#include "YuvConverter.h"
+#include "SliceThreadPool.h"
+#include "FrameMailbox.h"
+#include "PacketQueue.h"
+#include "DecodeGovernor.h"
+#include "MjpegDecodePool.h"
+#include "SpscQueue.h"
+#include "StageMeter.h"
+#include "MemoryBudget.h"
+#include "BlockHasher.h"
+
+#include <memory>
+
 class VideoDecoderWorker : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit VideoDecoderWorker(QObject* parent = nullptr);
+    explicit VideoDecoderWorker(const DeskVideoConfig& config, const std::shared_ptr<PacketQueue>& packetQueue,
+                                const std::shared_ptr<FrameMailbox>& mailbox,
+                                const std::shared_ptr<MemoryBudget>& memoryBudget = nullptr, QObject* parent = nullptr);
     ~VideoDecoderWorker();
 
+    // 按配置选出输出 QImage 格式，AUTO 时跟随光栅绘制引擎的首选格式（需在 GUI 线程调用）
+    static QImage::Format frameFormatFor(DeskPixelFormat pixelFormat);
+
 public slots:
+    // PacketQueue 由空变非空时由网络线程投递，解码队列中的全部包
+    void drainPacketQueue();
     void decodePacket(const QByteArray& packetData);
+    // VideoWidget 尺寸变化时调用，解码线程直接转换并缩放到显示尺寸
+    void setTargetSize(const QSize& size);
+    // VideoWidget 缩放/平移后调用，只转换可见的源区域；用最近一帧立即按新区域重新发布
+    void setVisibleRect(const QRectF& rect);
+    // OpenGL 渲染时打开: 420 格式的帧不做色彩转换，直接把解码输出的引用发布到邮箱
+    void setYuvOutput(bool enabled);
     void decodePacket1(const QByteArray& packetData);
+    // 会话结束: 等在途帧发布完，关闭解码器并清空参数集等码流状态，线程和缓冲池保留给下一个会话
+    void resetSession();
     void cleanup();
 
 signals:
-    void frameDecoded(const QImage& image);
+    // 邮箱里有新帧且 UI 已处理完上一次通知时发出，帧本身通过 FrameMailbox 传递
+    void frameAvailable();
 
 private:
+    // 按当前编码格式和配置创建并打开 codecCtx，有缓存的参数集时作为 extradata 注入
+    bool openDecoder();
+    // 换用另一种编码格式的解码器
+    void switchCodec(DeskVideoCodec videoCodec);
+    // MJPEG 帧交给并行解码线程池，按到达顺序发布
+    void submitMjpegFrame(const QByteArray& packetData, qint64 receivedNs);
+    // 关闭并重新打开解码器，之后只需等待下一个 IDR
+    void restartDecoder(const QString& reason);
+    // receivedNs 为包到达时间，info 为包的 NAL 结构概要
+    void decodePacket(const QByteArray& packetData, qint64 receivedNs, const PacketInfo& info);
+    // 按调节器级别设置跳过环路滤波、丢非参考帧、快速模式和缩放算法
+    void applyDecodeLevel(DecodeGovernor::Level level);
+    // 把 frame 的可见区域转换（必要时缩放）到显示尺寸并发布到邮箱；拆分拓扑下在转换线程调用
+    // 返回 false 表示转换失败，超出内存预算丢帧不算失败
+    bool convertAndPublish(const AVFrame* frame, const QSize& targetSize, const QRectF& visibleRect,
+                           int swsFlags, qint64 receivedNs);
+    // 可见区域变化后按最新区域重新转换最近一帧，由 setVisibleRect 排队，每批事件一次
+    void redrawVisibleRect();
+    // 拆分拓扑下把 frame 的引用交给转换线程（队列满时等待，等待时间累加到 stallNs），否则直接转换
+    bool dispatchConvert(const AVFrame* frame, qint64 receivedNs, qint64& stallNs);
+    // 发布 frame 的引用（不拷贝像素），色彩转换和缩放由 GLVideoRenderer 完成
+    void publishYuvFrame(const AVFrame* frame, qint64 receivedNs);
+    // 把 frame 转换（必要时缩放）到 image 的尺寸和格式
+    bool convertFrame(const AVFrame* frame, QImage& image, int swsFlags);
+    // 同尺寸输出时只转换变化的块，其余像素从上一帧输出拷贝
+    void convertChangedBlocks(const AVFrame* frame, QImage& image);
+    // crop 内的变化块换算到 outSize 坐标的重绘区域，缩放时向外扩一个像素覆盖插值的影响范围
+    QRegion changedRegion(const QRect& crop, const QSize& outSize) const;
+    // 按水平切片转换
+    bool convertSlices(const AVFrame* frame, QImage& image, bool useYuvKernel, int swsFlags);
+    // 转换耗时写入 StreamStats，由执行转换的线程调用
+    void reportConvertStats();
+    // 解码线程的累计统计每 DECODER_STATS_INTERVAL 个包写入一次 StreamStats
+    void reportDecoderStats();
+    void reportMjpegStats();
+    // 两个帧缓冲池的占用写入内存预算
+    void updateMemoryUsage();
+    // 拆分拓扑的转换线程
+    void startConvertThread();
+    void stopConvertThread();
+    void convertLoop();
+    // 等待转换队列中的帧全部发布
+    void waitConvertIdle();
+
     const AVCodec* codec = nullptr;
     AVCodecContext* codecCtx = nullptr;
     AVFrame* frame = nullptr;
     SwsContext* swsCtx = nullptr;
 
+    // 复用的输入包及其缓冲池，稳态解码不再分配内存
+    AVPacket* m_packet = nullptr;
+    PacketPool m_packetPool;
+
+    // 送入解码器的包数；每包拷贝和引用管理的开销由 bench_decode 测量
+    qint64 m_packetCount = 0;
+    // avcodec_send_packet 失败次数，及当前连续失败次数
+    qint64 m_sendErrors = 0;
+    int m_sendErrorRun = 0;
+    // 两次汇总之间处理的包数，以及最近一个包的大小和解码耗时
+    int m_statsPackets = 0;
+    int m_lastPacketBytes = 0;
+    qint64 m_lastDecodeNs = 0;
+
+    // 解码器切片线程数
+    int m_decodeThreads = 1;
+    // 当前码流的编码格式，AUTO 表示尚未识别、解码器未打开
+    DeskVideoCodec m_videoCodec = VIDEO_CODEC_AUTO;
+    DeskVideoCodec m_configuredCodec = VIDEO_CODEC_AUTO;
+    // 最近一次收到的各类参数集（H.264/HEVC 带起始码），按类型排序，解码器重启时注入
+    // 每类只保留一份，对应单路编码器每次只使用一组参数集的情况
+    QMap<int, QByteArray> m_parameterSets;
+    int m_decoderRestarts = 0;
+    // 上一帧的源分辨率，用于发现 SPS 分辨率变化
+    QSize m_sourceSize;
+
+    // 从恢复点 SEI 开始解码时，刷新完成前还需隐藏的画面数
+    int m_recoveryPicturesLeft = 0;
+    int m_recoveryStarts = 0;
+    qint64 m_hiddenFrames = 0;
+
+    // MJPEG 并行解码线程数（<= 1 时走单解码器路径），线程池在首个 MJPEG 帧到达时创建
+    int m_mjpegThreads = 1;
+    std::unique_ptr<MjpegDecodePool> m_mjpegPool;
+
+    // RGB 输出帧缓冲池，QImage 析构时缓冲区自动回池
+    FramePool m_framePool;
+    // 会话内存预算，帧缓冲超出时丢弃新帧
+    std::shared_ptr<MemoryBudget> m_memoryBudget;
+
+    // 网络线程写入的有界包队列，积压时按 GOP 结构丢弃过期包
+    std::shared_ptr<PacketQueue> m_packetQueue;
+    qint64 m_queueLatencyNs = 0;
+    // 已解码的各类型 NAL 数，由包队列中的 NAL 索引统计
+    qint64 m_nalCounts[32] = {};
+
+    // 解码结果只保留最新一帧，UI 绘制时自取
+    std::shared_ptr<FrameMailbox> m_mailbox;
+
+    // 输出格式，与绘制引擎一致以免 drawImage 每次重绘都做格式转换
+    QImage::Format m_imageFormat = QImage::Format_RGB32;
+    AVPixelFormat m_swsFormat = AV_PIX_FMT_RGB32;
+
+    // VideoWidget 当前尺寸，为空时按源分辨率输出
+    QSize m_targetSize;
+    // VideoWidget 放大后的可见区域（归一化），为空表示整个画面
+    QRectF m_visibleRect;
+    // 可见区域变化后还没有帧按新区域转换过；重新转换已排队
+    bool m_visibleRectDirty = false;
+    bool m_redrawQueued = false;
+    bool m_yuvOutput = false;
+    // 最近一帧解码输出的引用，可见区域变化时重新转换（静止画面时服务端可能很久不发新帧）
+    AVFrame* m_lastFrame = nullptr;
+    // 可见区域的裁剪视图（引用 + av_frame_apply_cropping），只在执行转换的线程使用
+    AVFrame* m_cropFrame = nullptr;
+
+    // CPU 跟不上时逐级降低解码质量
+    DecodeGovernor m_governor;
+    int m_swsFlags = SWS_BILINEAR;
+
+    // 同尺寸色彩转换的 SIMD 内核，按 CPU 特性选择
+    YuvConverter m_yuvConverter;
+
+    // 拆分拓扑下交给转换线程的一帧，frame 为解码输出的引用（不拷贝像素）
+    // 目标尺寸和缩放算法随帧传递，转换线程不读取解码线程的成员
+    struct ConvertJob
+    {
+        AVFrame* frame = nullptr;
+        QSize targetSize;
+        QRectF visibleRect;
+        int swsFlags = SWS_BILINEAR;
+        qint64 receivedNs = 0;
+    };
+    // 解码 -> 转换的无锁队列；两个信号量分别计空位和待转换帧，队列满时解码线程等待
+    // 未拆分时均为空，转换在解码线程上完成
+    std::unique_ptr<SpscQueue<ConvertJob>> m_convertQueue;
+    QSemaphore m_convertFree;
+    QSemaphore m_convertItems;
+    QThread* m_convertThread = nullptr;
+    DeskThreadPolicy m_convertPolicy;
+    std::atomic<bool> m_convertQuit{false};
+    // 解码阶段占用率，转换阶段的统计在转换线程内
+    StageMeter m_decodeStage{"decode"};
+
+    // 常驻切片线程池，多核并行做色彩转换；单核设备上为空
+    std::unique_ptr<SliceThreadPool> m_slicePool;
+    // 不缩放但专用内核不支持的格式，每个切片一个 SwsContext
+    QVector<SwsContext*> m_sliceSwsCtx;
+
+    // 块级变化检测，只在执行转换的线程访问；m_lastImage 是上一次发布的输出，未变化的块从这里拷贝
+    bool m_changeDetection = true;
+    BlockHasher m_blockHasher;
+    QImage m_lastImage;
+    QRect m_lastCrop;
+    qint64 m_hashNs = 0;
+    qint64 m_changeFrames = 0;
+    qint64 m_identicalFrames = 0;
+    qint64 m_changePixels = 0;
+    qint64 m_skippedPixels = 0;
+
+    // 转换耗时统计，专用内核与 sws_scale 分开累计便于对比
+    enum ConvertPath { ConvertSws = 0, ConvertYuv = 1 };
+    qint64 m_convertNs[2] = { 0, 0 };
+    qint64 m_convertCount[2] = { 0, 0 };
+
     mutable QMutex m_mutex;
-    QQueue<QByteArray> m_queue;
     //QTimer m_timer;
     QTimer* m_timer = nullptr;
 
@@ -2,8 +2,13 @@
 #include "NetworkWorker.h"
 #include "VideoDecoderWorker.h"
 #include "LogWidget.h"
+#include "StreamStats.h"
+#include "AccessUnitAssembler.h"
+#include "StreamRecorder.h"
+#include "StageMeter.h"
+#include "ThreadTuning.h"
 
-VideoReceiver::VideoReceiver(QObject* parent)
+VideoReceiver::VideoReceiver(const DeskVideoConfig& config, QObject* parent)
     : QObject(parent)
 {
     // 1) 创建线程
@@ -11,8 +16,13 @@ VideoReceiver::VideoReceiver(QObject* parent)
     m_decodeThread = new QThread(this);
 
     // 2) 创建两个 Worker，但不指定 parent（后面 moveToThread）
+    // 接收缓冲、包队列、帧缓冲和发送队列共用一份内存预算
+    m_memoryBudget = std::make_shared<MemoryBudget>(config.memoryBudget);
     m_netWorker = new NetworkWorker();           // 负责 TCP 网络收包
-    m_decoderWorker = new VideoDecoderWorker();  // 负责解码
+    m_netWorker->setMemoryBudget(m_memoryBudget);
+    m_packetQueue = std::make_shared<PacketQueue>(config.maxQueuedPackets, config.latencyBudgetMs, m_memoryBudget);
+    m_frameMailbox = std::make_shared<FrameMailbox>();
+    m_decoderWorker = new VideoDecoderWorker(config, m_packetQueue, m_frameMailbox, m_memoryBudget);  // 负责解码
 
     // 3) 移动到各自的线程
     m_netWorker->moveToThread(m_networkThread);
@@ -23,18 +33,65 @@ VideoReceiver::VideoReceiver(QObject* parent)
     connect(m_decodeThread, &QThread::finished, m_decoderWorker, &QObject::deleteLater);
 
     // 5) 信号槽连接
-    // 当网络线程拆完一包数据，就发给解码线程
-    connect(m_netWorker, &NetworkWorker::packetReady,
-            m_decoderWorker, &VideoDecoderWorker::decodePacket,
-            Qt::QueuedConnection);
+    // 当网络线程拆完一包数据，先在网络线程按访问单元重新分组，再写入有界包队列，
+    // 队列由空变非空时才唤醒解码线程，积压时由队列丢弃过期包
+    std::shared_ptr<PacketQueue> packetQueue = m_packetQueue;
+    m_assembler = std::make_shared<AccessUnitAssembler>(config.accessUnitMode, config.codec);
+    std::shared_ptr<AccessUnitAssembler> assembler = m_assembler;
+    std::shared_ptr<StreamRecorder> recorder;
+    if (!config.recordStreamPath.isEmpty()) {
+        recorder = std::make_shared<StreamRecorder>();
+        recorder->open(config.recordStreamPath);
+    }
+    VideoDecoderWorker* decoderWorker = m_decoderWorker;
+    // 接收/组帧阶段的占用率，只在网络线程访问
+    std::shared_ptr<StageMeter> parseStage = std::make_shared<StageMeter>("parse");
+    m_suspended = std::make_shared<std::atomic<bool>>(false);
+    std::shared_ptr<std::atomic<bool>> suspended = m_suspended;
+    connect(m_netWorker, &NetworkWorker::packetReady, m_netWorker,
+            [packetQueue, assembler, recorder, decoderWorker, parseStage, suspended](const QByteArray& packetData) {
+                if (suspended->load(std::memory_order_relaxed)) {
+                    StreamStats::instance()->addValue("power.skippedPackets");
+                    return;
+                }
+                qint64 startNs = StreamStats::nowNs();
+                if (recorder) {
+                    recorder->write(packetData);
+                }
+                QVector<AccessUnit> units;
+                assembler->push(packetData, units);
+                bool wake = false;
+                for (const AccessUnit& unit : units) {
+                    wake |= packetQueue->push(unit);
+                }
+                if (wake) {
+                    QMetaObject::invokeMethod(decoderWorker, "drainPacketQueue", Qt::QueuedConnection);
+                }
+
+                StreamStats* stats = StreamStats::instance();
+                stats->setValue("au.merged", assembler->mergedCount());
+                stats->setValue("au.split", assembler->splitCount());
+                stats->setValue("au.pendingBytes", assembler->pendingBytes());
+                parseStage->addBusy(StreamStats::nowNs() - startNs);
+                parseStage->report();
+            },
+            Qt::DirectConnection);
+    // 网络线程跳过了超大的包: 与暂停恢复一样丢弃半帧和排队的包，包队列等待关键帧，解码器清空参考帧
+    connect(m_netWorker, &NetworkWorker::streamDiscontinuity, m_netWorker,
+            [packetQueue, assembler]() {
+                assembler->reset();
+                packetQueue->reset();
+                StreamStats::instance()->addValue("net.oversizeSkipped");
+            },
+            Qt::DirectConnection);
 
     connect(m_netWorker, &NetworkWorker::onClipboardMessageReceived,
             this, &VideoReceiver::onClipboardMessageReceived,
             Qt::QueuedConnection);
 
-    // 解码完成后回到主线程
-    connect(m_decoderWorker, &VideoDecoderWorker::frameDecoded,
-            this, &VideoReceiver::onFrameDecoded,
+    // 解码完成后回到主线程，只投递通知，帧由 UI 绘制时从邮箱取
+    connect(m_decoderWorker, &VideoDecoderWorker::frameAvailable,
+            this, &VideoReceiver::frameAvailable,
             Qt::QueuedConnection);
 
     // 网络出错 -> 通知本类
@@ -45,44 +102,130 @@ VideoReceiver::VideoReceiver(QObject* parent)
     // 启动线程，让它们的事件循环开始工作
     m_networkThread->start();
     m_decodeThread->start();
-}
 
-VideoReceiver::~VideoReceiver()
-{
-    stopReceiving();
+    // nice 和亲和性是线程级的，要在各自线程内设置；解码线程上创建的 MJPEG 解码线程会继承解码线程的设置
+    DeskThreadPolicy networkPolicy = config.networkThread;
+    DeskThreadPolicy decodePolicy = config.decodeThread;
+    QMetaObject::invokeMethod(m_netWorker, [networkPolicy]() {
+        applyThreadPolicy("network", networkPolicy);
+    }, Qt::QueuedConnection);
+    QMetaObject::invokeMethod(m_decoderWorker, [decodePolicy]() {
+        applyThreadPolicy("decode", decodePolicy);
+    }, Qt::QueuedConnection);
 }
 
-void VideoReceiver::stopReceiving()
+VideoReceiver::~VideoReceiver()
 {
-    if (m_stopped)
-        return;
-
     QMetaObject::invokeMethod(m_netWorker, "cleanup", Qt::QueuedConnection);
     QMetaObject::invokeMethod(m_decoderWorker, "cleanup", Qt::QueuedConnection);
     m_networkThread->quit();
     m_decodeThread->quit();
     m_networkThread->wait();
     m_decodeThread->wait();
-    m_stopped = true;
+}
+
+void VideoReceiver::stopSession()
+{
+    if (!m_sessionActive)
+        return;
+    m_sessionActive = false;
+    // 新会话总是从运行状态开始，排队的复位会丢弃暂停期间的残留数据
+    m_suspended->store(false);
+
+    // 先在网络线程关闭 socket 并丢弃半帧数据和排队的包，网络线程之后不会再投递旧会话的包；
+    // 再由网络线程把解码器复位排到解码线程，排在新会话的任何 drainPacketQueue 之前
+    NetworkWorker* netWorker = m_netWorker;
+    VideoDecoderWorker* decoderWorker = m_decoderWorker;
+    std::shared_ptr<PacketQueue> packetQueue = m_packetQueue;
+    std::shared_ptr<AccessUnitAssembler> assembler = m_assembler;
+    QMetaObject::invokeMethod(netWorker, [this, netWorker, decoderWorker, packetQueue, assembler]() {
+        netWorker->cleanup();
+        assembler->restart();
+        packetQueue->reset();
+        QMetaObject::invokeMethod(decoderWorker, [this, decoderWorker]() {
+            decoderWorker->resetSession();
+            emit sessionStopped();
+        }, Qt::QueuedConnection);
+    }, Qt::QueuedConnection);
 }
 
 void VideoReceiver::startConnect(const QString& host, quint16 port, const QString& uuid)
 {
+    // 上一个会话最后发布、UI 没来得及取走的帧留在邮箱里会让新帧不再触发通知，这里以消费者身份取走
+    VideoFrame staleFrame;
+    m_frameMailbox->take(staleFrame);
+
     // 主线程里只要 调用 Worker 的 connectToServer，即可让网络线程连
     // 这里需要使用 invokeMethod 或 queued signal 来跨线程调用
     QMetaObject::invokeMethod(m_netWorker, "connectToServer", Qt::QueuedConnection,
                               Q_ARG(QString, host),
                               Q_ARG(quint16, port),
                               Q_ARG(QString, uuid));
-    m_stopped = false;
+    m_sessionActive = true;
+    m_phaseStartNs = StreamStats::nowNs();
+    m_phaseCpuNs = StreamStats::processCpuNs();
 }
 
-void VideoReceiver::onFrameDecoded(const QImage& img)
+double VideoReceiver::finishPowerPhase()
 {
-    // LogWidget::instance()->addLog(QString("[VideoReceiver] onFrameDecoded, size: %1x%2, isNull: %3")
-    //                                   .arg(img.width()).arg(img.height()).arg(img.isNull()), LogWidget::Info);
+    qint64 nowNs = StreamStats::nowNs();
+    qint64 cpuNs = StreamStats::processCpuNs();
+    qint64 wallNs = nowNs - m_phaseStartNs;
+    double cpuPct = wallNs > 0 ? 100.0 * (cpuNs - m_phaseCpuNs) / wallNs : 0.0;
+    m_phaseStartNs = nowNs;
+    m_phaseCpuNs = cpuNs;
+    return cpuPct;
+}
+
+void VideoReceiver::setSuspended(bool suspended)
+{
+    if (!m_sessionActive || m_suspended->load() == suspended)
+        return;
+
+    // 进程 CPU 时间包含 UI 线程，两个阶段的差值就是暂停省下的解码、转换和绘制开销
+    qint64 phaseMs = (StreamStats::nowNs() - m_phaseStartNs) / 1000000;
+    double cpuPct = finishPowerPhase();
+    StreamStats::instance()->setValue(suspended ? "power.activeCpuPct" : "power.suspendedCpuPct",
+                                      qRound(cpuPct * 10) / 10.0);
+    LogWidget::instance()->addLog(QString("[Power] %1 after %2 ms %3 at %4% CPU")
+                                      .arg(suspended ? "Suspending" : "Resuming")
+                                      .arg(phaseMs)
+                                      .arg(suspended ? "active" : "suspended")
+                                      .arg(cpuPct, 0, 'f', 1), LogWidget::Info);
+
+    // 暂停时先置位，网络线程立即停止投递；恢复时在网络线程清掉半帧和排队的旧包后才放行，
+    // 包队列复位后等待关键帧，解码器收到不连续标记后清空参考帧
+    if (suspended) {
+        m_suspended->store(true);
+    }
+    std::shared_ptr<std::atomic<bool>> suspendedFlag = m_suspended;
+    std::shared_ptr<PacketQueue> packetQueue = m_packetQueue;
+    std::shared_ptr<AccessUnitAssembler> assembler = m_assembler;
+    QMetaObject::invokeMethod(m_netWorker, [suspended, suspendedFlag, packetQueue, assembler]() {
+        assembler->restart();
+        packetQueue->reset();
+        if (!suspended) {
+            suspendedFlag->store(false);
+        }
+    }, Qt::QueuedConnection);
+}
 
-    emit frameReady(img);
+void VideoReceiver::setTargetSize(const QSize& size)
+{
+    QMetaObject::invokeMethod(m_decoderWorker, "setTargetSize", Qt::QueuedConnection,
+                              Q_ARG(QSize, size));
+}
+
+void VideoReceiver::setVisibleRect(const QRectF& rect)
+{
+    QMetaObject::invokeMethod(m_decoderWorker, "setVisibleRect", Qt::QueuedConnection,
+                              Q_ARG(QRectF, rect));
+}
+
+void VideoReceiver::setYuvOutput(bool enabled)
+{
+    QMetaObject::invokeMethod(m_decoderWorker, "setYuvOutput", Qt::QueuedConnection,
+                              Q_ARG(bool, enabled));
 }
 
 void VideoReceiver::onNetworkError(const QString& err)
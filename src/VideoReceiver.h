@@ -6,38 +6,65 @@
 #include <QImage>
 #include <QVariant>
 #include "rendezvous.pb.h"
+#include "DeskDefine.h"
+#include "FrameMailbox.h"
+#include "PacketQueue.h"
+#include "MemoryBudget.h"
+
+#include <atomic>
+#include <memory>
 
 class NetworkWorker;
 class VideoDecoderWorker;
+class AccessUnitAssembler;
 
+// 视频接收流水线，整个程序只创建一次
+// 网络线程和解码线程常驻，各会话之间复用，切换会话只重建 socket 和解码器状态。
 class VideoReceiver : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit VideoReceiver(QObject* parent = nullptr);
+    explicit VideoReceiver(const DeskVideoConfig& config, QObject* parent = nullptr);
+    // 程序退出时阻塞等待两个线程结束
     ~VideoReceiver();
 
     // 主线程调用，用于发起连接
     void startConnect(const QString& host, quint16 port, const QString& uuid);
-    void stopReceiving();
+    // 异步结束当前会话，立即返回；网络和解码状态都清理完后发出 sessionStopped()
+    void stopSession();
+    bool isSessionActive() const { return m_sessionActive; }
+    // 程序退到后台时暂停: socket 保持连接继续读取，收到的视频包在网络线程直接丢弃，解码和转换线程空闲；
+    // 恢复时丢弃半帧和排队数据，从下一个关键帧继续。显示控件保留暂停前的最后一帧。
+    // 协议没有暂停推流和请求关键帧的消息，服务端照常发送，节省的是本端的解码、转换和绘制
+    void setSuspended(bool suspended);
+    bool isSuspended() const { return m_suspended->load(); }
+
+    // 解码线程发布最新帧的邮箱，显示控件从这里取帧
+    std::shared_ptr<FrameMailbox> frameMailbox() const { return m_frameMailbox; }
 
 signals:
-    // 当成功解码一帧时，把图像发给外层（比如给 VideoWidget 显示）
-    void frameReady(const QImage& image);
+    // 邮箱里有新帧时通知外层（比如让 VideoWidget 刷新），帧本身从 frameMailbox() 取
+    void frameAvailable();
     // 可以把 NetworkWorker 的错误转发出去
     void networkError(const QString& error);
     void onClipboardMessageReceived(const ClipboardEvent& clipboardEvent);
+    // stopSession() 完成，可以开始下一个会话
+    void sessionStopped();
 
 public slots:
     void mouseEventCaptured(int x, int y, int mask, int value);
     void touchEventCaptured(QVariant value);
     void keyEventCaptured(int key, bool pressed);
     void clipboardDataCaptured(const ClipboardEvent& clipboardEvent);
+    // 显示控件尺寸变化，转给解码线程
+    void setTargetSize(const QSize& size);
+    // 显示控件缩放/平移后的可见区域（相对源画面的归一化矩形），转给解码线程只转换这一块
+    void setVisibleRect(const QRectF& rect);
+    // 显示控件选定渲染方式后调用，true 时解码线程输出 YUV 帧
+    void setYuvOutput(bool enabled);
 
 private slots:
-    // 当解码线程发出 frameDecoded 时调用
-    void onFrameDecoded(const QImage& img);
     // 当 NetworkWorker 报错时
     void onNetworkError(const QString& err);
 
@@ -46,7 +73,19 @@ private:
     QThread* m_decodeThread = nullptr;
     NetworkWorker* m_netWorker = nullptr;
     VideoDecoderWorker* m_decoderWorker = nullptr;
-    bool m_stopped;
+    std::shared_ptr<PacketQueue> m_packetQueue;
+    std::shared_ptr<AccessUnitAssembler> m_assembler;
+    std::shared_ptr<FrameMailbox> m_frameMailbox;
+    std::shared_ptr<MemoryBudget> m_memoryBudget;
+    bool m_sessionActive = false;
+
+    // 网络线程的包回调读取，主线程写入
+    std::shared_ptr<std::atomic<bool>> m_suspended;
+    // 当前阶段（运行或暂停）开始时的时间和进程 CPU 时间，用于对比两种状态的 CPU 占用
+    qint64 m_phaseStartNs = 0;
+    qint64 m_phaseCpuNs = 0;
+    // 结束当前阶段，返回该阶段的 CPU 占用（单核百分比）
+    double finishPowerPhase();
 };
 
 #endif // VIDEORECEIVER_H
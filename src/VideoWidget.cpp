@@ -1,13 +1,25 @@
 #include "VideoWidget.h"
 #include <QPainter>
+#include <QPaintEvent>
+#include <QRegion>
 #include <QKeyEvent>
+#include <QLineF>
 #include <QDebug>
 
 #include "LogWidget.h"
 #include "DeskDefine.h"
+#include "StreamStats.h"
+#include "GLVideoRenderer.h"
+#include "MultimediaVideoOutput.h"
 
 #define BTN_FIXED_W 80
 
+// 每累计多少次绘制汇总一次显示延迟
+#define PAINT_STATS_INTERVAL 120
+
+// 缩小到接近 1 倍时直接回到整个画面，避免只差几个像素的裁剪
+#define ZOOM_SNAP_WIDTH 0.99
+
 VideoWidget::VideoWidget(QWidget* parent)
     : QWidget(parent)
     , m_offsetX(0)
@@ -24,7 +36,8 @@ VideoWidget::VideoWidget(QWidget* parent)
     // 启用悬停事件
     setAttribute(Qt::WA_Hover);
 
-    setAttribute(Qt::WA_OpaquePaintEvent, false);
+    // paintEvent 自己画黑边，跳过 Qt 每帧对整个控件的背景填充
+    setAttribute(Qt::WA_OpaquePaintEvent, true);
 
     m_closeBtn = new QPushButton("X", this);
     m_closeBtn->setFixedSize(BTN_FIXED_W, BTN_FIXED_W);
@@ -33,12 +46,13 @@ VideoWidget::VideoWidget(QWidget* parent)
     m_closeBtn->hide();
 }
 
-void VideoWidget::setFrame(const QImage& image)
+void VideoWidget::setFrame(const QImage& image, const QSize& sourceSize)
 {
     // LogWidget::instance()->addLog(QString("[VideoWidget] setFrame, size: %1x%2, isNull: %3")
     //                                   .arg(image.width()).arg(image.height()).arg(image.isNull()), LogWidget::Info);
 
     m_currentFrame = image;
+    m_sourceSize = sourceSize;
 
     // // 首帧时设置固定尺寸（用于滚动区域）
     // if (m_firstFrame && !m_currentFrame.isNull())
@@ -51,6 +65,248 @@ void VideoWidget::setFrame(const QImage& image)
     update();
 }
 
+void VideoWidget::setFrameMailbox(const std::shared_ptr<FrameMailbox>& mailbox)
+{
+    m_mailbox = mailbox;
+}
+
+void VideoWidget::setSmoothScaling(bool smooth)
+{
+    m_smoothScaling = smooth;
+    if (m_glRenderer)
+    {
+        m_glRenderer->setSmoothScaling(smooth);
+    }
+}
+
+void VideoWidget::setMaxZoom(qreal zoom)
+{
+    m_maxZoom = zoom;
+    if (m_maxZoom <= 1.0)
+    {
+        m_pinching = false;
+        applyVisibleRect(QRectF(0, 0, 1, 1));
+    }
+}
+
+void VideoWidget::setRenderer(DeskRenderer renderer)
+{
+    destroyYuvView();
+
+    if (renderer == RENDERER_OPENGL && !GLVideoRenderer::isAvailable())
+    {
+        LogWidget::instance()->addLog("OpenGL context unavailable, falling back to raster rendering", LogWidget::Warning);
+        renderer = RENDERER_RASTER;
+    }
+
+    if (renderer == RENDERER_OPENGL)
+    {
+        m_glRenderer = new GLVideoRenderer(this);
+        m_glRenderer->setSmoothScaling(m_smoothScaling);
+        m_glRenderer->setVisibleRect(m_visibleRect);
+        connect(m_glRenderer, &GLVideoRenderer::initFailed, this, &VideoWidget::onYuvViewFailed);
+        m_yuvView = m_glRenderer;
+    }
+    else if (renderer == RENDERER_MULTIMEDIA)
+    {
+        QVideoWidget* view = new QVideoWidget(this);
+        m_multimediaOutput = new MultimediaVideoOutput(view, view);
+        m_multimediaOutput->setVisibleRect(m_visibleRect);
+        m_yuvView = view;
+    }
+
+    if (m_yuvView)
+    {
+        // 输入事件穿透到本控件，坐标映射和关闭按钮逻辑不变
+        m_yuvView->setAttribute(Qt::WA_TransparentForMouseEvents);
+        m_yuvView->setGeometry(m_drawRect);
+        m_yuvView->hide();
+        m_closeBtn->raise();
+    }
+    emit yuvOutputChanged(m_yuvView != nullptr);
+}
+
+void VideoWidget::destroyYuvView()
+{
+    if (m_yuvView)
+    {
+        m_yuvView->hide();
+        m_yuvView->deleteLater();
+    }
+    m_yuvView = nullptr;
+    m_glRenderer = nullptr;
+    m_multimediaOutput = nullptr;
+}
+
+void VideoWidget::onYuvViewFailed()
+{
+    LogWidget::instance()->addLog("YUV renderer failed, falling back to raster rendering", LogWidget::Warning);
+    destroyYuvView();
+    emit yuvOutputChanged(false);
+    update();
+}
+
+void VideoWidget::acceptFrame(const VideoFrame& frame)
+{
+    m_currentFrame = frame.image;
+    m_sourceSize = frame.sourceSize;
+    m_imageRect = frame.visibleRect;
+
+    qint64 now = StreamStats::nowNs();
+    if (frame.receivedNs > 0)
+    {
+        m_latencyNs += now - frame.receivedNs;
+        m_queueLatencyNs += now - frame.decodedNs;
+        ++m_latencyCount;
+    }
+}
+
+void VideoWidget::onFrameAvailable()
+{
+    // 在这里而不是 paintEvent 里取帧: 重绘前要知道这一帧的变化区域；
+    // YUV 子控件盖住显示区域时本控件的 paintEvent 也不一定会被调用
+    VideoFrame latest;
+    if (!m_mailbox || !m_mailbox->take(latest))
+    {
+        return;
+    }
+    QSize previousSize = m_currentFrame.size();
+    QRectF previousRect = m_imageRect;
+    acceptFrame(latest);
+    bool geometryChanged = updateDrawRect();
+
+    if (m_yuvView)
+    {
+        if (latest.yuv)
+        {
+            if (m_glRenderer)
+            {
+                m_glRenderer->setFrame(latest);
+            }
+            else if (!m_multimediaOutput->present(latest))
+            {
+                onYuvViewFailed();
+                return;
+            }
+            m_yuvView->show();
+        }
+        else
+        {
+            // 切换过程中或不支持的格式（如并行解码的 MJPEG）仍是 RGB 帧，由本控件绘制
+            m_yuvView->hide();
+            update();
+        }
+        return;
+    }
+
+    // 还没有帧或远端分辨率变化时显示区域也变了，整体刷新
+    if (geometryChanged || m_drawRect.isEmpty())
+    {
+        update();
+        return;
+    }
+
+    // 输出与显示区域 1:1（放大时还要求就是当前可见区域）时只重绘解码线程标出的变化块，
+    // 否则刷新整个显示区域；黑边不变
+    QSize imageSize = latest.image.size();
+    if (!latest.dirty.isEmpty() && imageSize == previousSize && imageSize == m_drawRect.size()
+        && m_imageRect == previousRect && m_imageRect == m_visibleRect)
+    {
+        update(latest.dirty.translated(m_drawRect.topLeft()));
+    }
+    else
+    {
+        update(m_drawRect);
+    }
+}
+
+bool VideoWidget::updateDrawRect()
+{
+    QSize imageSize = m_sourceSize.isEmpty() ? m_currentFrame.size() : m_sourceSize;
+    if (size() == m_geometrySize && imageSize == m_geometrySource)
+    {
+        return false;
+    }
+    m_geometrySize = size();
+    m_geometrySource = imageSize;
+
+    // 计算保持比例的缩放，按远端原始分辨率计算，保证坐标映射正确
+    QRect drawRect = deskLetterboxRect(size(), imageSize);
+    bool changed = drawRect != m_drawRect;
+    m_drawRect = drawRect;
+    if (m_yuvView)
+    {
+        m_yuvView->setGeometry(drawRect);
+    }
+    updateViewTransform();
+    // 远端分辨率变了，可见区域按新分辨率重新对齐
+    if (m_visibleRect.width() < 1.0)
+    {
+        applyVisibleRect(m_visibleRect);
+    }
+    return changed;
+}
+
+void VideoWidget::updateViewTransform()
+{
+    if (m_drawRect.isEmpty() || m_geometrySource.isEmpty())
+    {
+        return;
+    }
+    // 显示区域对应可见区域: 放大 N 倍时比例放大 N 倍，偏移再减去可见区域起点
+    qreal sourceWidth = m_geometrySource.width();
+    qreal sourceHeight = m_geometrySource.height();
+    m_scale = m_drawRect.width() / (m_visibleRect.width() * sourceWidth);
+    // 计算偏移量
+    m_offsetX = m_drawRect.x() - m_visibleRect.x() * sourceWidth * m_scale;
+    m_offsetY = m_drawRect.y() - m_visibleRect.y() * sourceHeight * m_scale;
+}
+
+QPointF VideoWidget::mapToSource(const QPointF& pos) const
+{
+    // 先减去偏移量，再除以缩放比例
+    return QPointF((pos.x() - m_offsetX) / m_scale, (pos.y() - m_offsetY) / m_scale);
+}
+
+QRectF VideoWidget::imageTarget() const
+{
+    qreal width = m_geometrySource.width() * m_scale;
+    qreal height = m_geometrySource.height() * m_scale;
+    return QRectF(m_offsetX + m_imageRect.x() * width, m_offsetY + m_imageRect.y() * height,
+                  m_imageRect.width() * width, m_imageRect.height() * height);
+}
+
+void VideoWidget::applyVisibleRect(const QRectF& rect)
+{
+    QRectF visible(0, 0, 1, 1);
+    if (rect.width() < ZOOM_SNAP_WIDTH && !m_geometrySource.isEmpty())
+    {
+        // 先把起点夹到画面内，再对齐到与解码线程相同的偶数像素区域
+        qreal x = qBound(0.0, rect.x(), 1.0 - rect.width());
+        qreal y = qBound(0.0, rect.y(), 1.0 - rect.height());
+        QRect crop = deskVisibleSourceRect(QRectF(x, y, rect.width(), rect.height()), m_geometrySource);
+        visible = deskNormalizedRect(crop, m_geometrySource);
+    }
+    if (visible == m_visibleRect)
+    {
+        return;
+    }
+
+    m_visibleRect = visible;
+    updateViewTransform();
+    if (m_glRenderer)
+    {
+        m_glRenderer->setVisibleRect(visible);
+    }
+    else if (m_multimediaOutput)
+    {
+        m_multimediaOutput->setVisibleRect(visible);
+    }
+    // 解码线程跟上之前先把当前帧按新区域摆放
+    update(m_drawRect);
+    emit visibleRectChanged(visible);
+}
+
 void VideoWidget::setPreValue(const qreal &scale)
 {
     m_scale = scale;
@@ -71,42 +327,65 @@ void VideoWidget::setPreValue(const qreal &scale)
 // }
 void VideoWidget::paintEvent(QPaintEvent* event)
 {
-    Q_UNUSED(event);
+    // 帧已在 onFrameAvailable 里从邮箱取出
+    bool geometryChanged = updateDrawRect();
     QPainter painter(this);
 
-    painter.fillRect(rect(), Qt::black);
-
+    // 不透明绘制，本次刷新区域内显示区域以外的部分都要自己填黑
+    QRegion bars = QRegion(event->rect()) - m_drawRect;
     if (m_currentFrame.isNull())
     {
-        return;
+        bars = event->rect();
+    }
+    for (const QRect& bar : bars)
+    {
+        painter.fillRect(bar, Qt::black);
     }
 
-    // 计算保持比例的缩放
-    QSize widgetSize = this->size();
-    QSize imageSize = m_currentFrame.size();
-
-    if (imageSize.isEmpty()) return;
-
-    qreal scaleW = (qreal)widgetSize.width() / imageSize.width();
-    qreal scaleH = (qreal)widgetSize.height() / imageSize.height();
-
-    m_scale = qMin(scaleW, scaleH);
+    if (m_currentFrame.isNull() || m_drawRect.isEmpty())
+    {
+        return;
+    }
 
-    // 计算实际显示的宽高
-    int drawW = static_cast<int>(imageSize.width() * m_scale);
-    int drawH = static_cast<int>(imageSize.height() * m_scale);
+    // 只刷新了旧的显示区域而远端分辨率变了，新显示区域露出的部分下一次补画
+    if (geometryChanged && !event->rect().contains(m_drawRect))
+    {
+        update();
+    }
 
-    // 计算偏移量
-    // 水平居中
-    m_offsetX = (widgetSize.width() - drawW) / 2;
+    // 在计算出的区域绘制图像，各帧格式的绘制开销见 bench_paint
+    if (m_currentFrame.size() == m_drawRect.size() && m_imageRect == m_visibleRect)
+    {
+        // 解码线程已缩放到显示尺寸，直接 1:1 贴图
+        painter.drawImage(m_drawRect.topLeft(), m_currentFrame);
+    }
+    else
+    {
+        // 尺寸或可见区域刚变化、解码线程尚未跟上时临时缩放；高倍放大时解码线程按可见区域原尺寸输出，由这里放大
+        // 帧不在显示区域之内的部分不画，没覆盖到的部分填黑
+        QRectF target = imageTarget();
+        painter.setClipRect(m_drawRect);
+        for (const QRect& uncovered : QRegion(m_drawRect) - QRegion(target.toAlignedRect()))
+        {
+            painter.fillRect(uncovered, Qt::black);
+        }
+        painter.setRenderHint(QPainter::SmoothPixmapTransform, m_smoothScaling);
+        painter.drawImage(target, m_currentFrame);
+    }
 
-    // 垂直下对齐
-    // 如果要垂直居中，则是 (widgetSize.height() - drawH) / 2
-    m_offsetY = widgetSize.height() - drawH;
+    if (++m_paintCount >= PAINT_STATS_INTERVAL)
+    {
+        m_paintCount = 0;
 
-    // 在计算出的区域绘制图像
-    QRect drawRect(m_offsetX, m_offsetY, drawW, drawH);
-    painter.drawImage(drawRect, m_currentFrame);
+        if (m_latencyCount > 0)
+        {
+            StreamStats::instance()->setValue("display.latencyUs", m_latencyNs / 1000 / m_latencyCount);
+            StreamStats::instance()->setValue("display.mailboxLatencyUs", m_queueLatencyNs / 1000 / m_latencyCount);
+            m_latencyNs = 0;
+            m_queueLatencyNs = 0;
+            m_latencyCount = 0;
+        }
+    }
 }
 
 void VideoWidget::mousePressEvent(QMouseEvent* event)
@@ -180,12 +459,18 @@ bool VideoWidget::event(QEvent *event)
     case QEvent::TouchBegin:
     case QEvent::TouchUpdate:
     case QEvent::TouchEnd:
+    case QEvent::TouchCancel:
     {
         return handleTouchEvent(static_cast<QTouchEvent*>(event));
     }
     case QEvent::Resize:
     {
         m_closeBtn->move(rect().right() - m_closeBtn->width(), 0);
+        emit targetSizeChanged(static_cast<QResizeEvent*>(event)->size());
+        if (m_yuvView)
+        {
+            updateDrawRect();
+        }
     }
     default:
         break;
@@ -243,9 +528,9 @@ void VideoWidget::handleMouseEvent(QPointF pos, int mask, int value)
 {
     if (!pos.isNull() && m_scale > 0)
     {
-        // 先减去偏移量，再除以缩放比例
-        int x = static_cast<int>((pos.x() - m_offsetX) / m_scale);
-        int y = static_cast<int>((pos.y() - m_offsetY) / m_scale);
+        QPointF source = mapToSource(pos);
+        int x = static_cast<int>(source.x());
+        int y = static_cast<int>(source.y());
 
         emit mouseEventCaptured(x, y, mask, value);
     }
@@ -253,10 +538,6 @@ void VideoWidget::handleMouseEvent(QPointF pos, int mask, int value)
 
 bool VideoWidget::handleTouchEvent(QTouchEvent *event)
 {
-    DeskTouchEvent protoEvent;
-    protoEvent.timestamp = QDateTime::currentMSecsSinceEpoch();
-    QList<DeskTouchPoint> points;
-
     QList<QTouchEvent::TouchPoint> touchPoints = event->touchPoints();
 
     // 判断点是不是在关闭按钮位置
@@ -275,6 +556,12 @@ bool VideoWidget::handleTouchEvent(QTouchEvent *event)
         }
     }
 
+    if (handlePinch(event))
+    {
+        event->accept();
+        return true;
+    }
+
     DeskTouchPhase touchPhase = TOUCH_CANCEL;
     switch (event->type())
     {
@@ -297,6 +584,20 @@ bool VideoWidget::handleTouchEvent(QTouchEvent *event)
         break;
     }
 
+    emitTouchPoints(touchPoints, touchPhase);
+    m_touchForwarded = touchPhase == TOUCH_BEGIN || touchPhase == TOUCH_MOVE;
+
+    event->accept(); // 必须调用accept()
+
+    return true;
+}
+
+void VideoWidget::emitTouchPoints(const QList<QTouchEvent::TouchPoint>& touchPoints, DeskTouchPhase phase)
+{
+    DeskTouchEvent protoEvent;
+    protoEvent.timestamp = QDateTime::currentMSecsSinceEpoch();
+    QList<DeskTouchPoint> points;
+
     static int count = 0;
     count += 1;
 
@@ -306,20 +607,21 @@ bool VideoWidget::handleTouchEvent(QTouchEvent *event)
         touchPt.id = pt.id();
         // touchPt.x  = pt.pos().x() / m_scale;
         // touchPt.y  = pt.pos().y() / m_scale;
-        // 触摸点坐标转换
+        // 触摸点坐标转换，与鼠标共用同一个视口变换
         if (m_scale > 0) {
-            touchPt.x  = (pt.pos().x() - m_offsetX) / m_scale;
-            touchPt.y  = (pt.pos().y() - m_offsetY) / m_scale;
+            QPointF source = mapToSource(pt.pos());
+            touchPt.x  = static_cast<int>(source.x());
+            touchPt.y  = static_cast<int>(source.y());
         } else {
             touchPt.x = 0;
             touchPt.y = 0;
         }
-        touchPt.phase = touchPhase;
+        touchPt.phase = phase;
         touchPt.pressure = pt.pressure();
         touchPt.size = pt.ellipseDiameters().width();
 
         // QString timeTemp = QDateTime::currentDateTime().toString("yyyy-hh-mm ss.zzz");
-        // qDebug() << "["+timeTemp+"]" << "----touchPoints:" << touchPt << touchPhase << touchPoints.size() << count;
+        // qDebug() << "["+timeTemp+"]" << "----touchPoints:" << touchPt << phase << touchPoints.size() << count;
 
         points.append(touchPt);
     }
@@ -327,8 +629,99 @@ bool VideoWidget::handleTouchEvent(QTouchEvent *event)
     protoEvent.points = points;
 
     emit touchEventCaptured(QVariant::fromValue(protoEvent));
+}
 
-    event->accept(); // 必须调用accept()
+bool VideoWidget::handlePinch(QTouchEvent* event)
+{
+    if (m_maxZoom <= 1.0)
+    {
+        return false;
+    }
+
+    QList<QTouchEvent::TouchPoint> pressed;
+    for (const QTouchEvent::TouchPoint& pt : event->touchPoints())
+    {
+        if (pt.state() != Qt::TouchPointReleased)
+        {
+            pressed.append(pt);
+        }
+    }
+    bool finished = event->type() == QEvent::TouchEnd || event->type() == QEvent::TouchCancel;
+
+    if (!m_pinching)
+    {
+        if (finished || pressed.size() < 2)
+        {
+            return false;
+        }
+        // 第二根手指落下前第一根已经作为触摸发给了远端，先取消，免得远端当成点击或拖动
+        if (m_touchForwarded)
+        {
+            emitTouchPoints(event->touchPoints(), TOUCH_CANCEL);
+            m_touchForwarded = false;
+        }
+        m_pinching = true;
+        beginPinch(pressed[0], pressed[1]);
+        return true;
+    }
+
+    // 手势一直持续到所有手指抬起，中途只剩一根手指时也不发给远端
+    if (finished)
+    {
+        m_pinching = false;
+        return true;
+    }
+    if (pressed.size() < 2)
+    {
+        return true;
+    }
 
+    const QTouchEvent::TouchPoint* first = nullptr;
+    const QTouchEvent::TouchPoint* second = nullptr;
+    for (const QTouchEvent::TouchPoint& pt : pressed)
+    {
+        if (pt.id() == m_pinchIds[0])
+        {
+            first = &pt;
+        }
+        else if (pt.id() == m_pinchIds[1])
+        {
+            second = &pt;
+        }
+    }
+    if (!first || !second)
+    {
+        // 起始手指抬起了一根又换了一根，从当前位置重新开始
+        beginPinch(pressed[0], pressed[1]);
+        return true;
+    }
+    updatePinch(first->pos(), second->pos());
     return true;
 }
+
+void VideoWidget::beginPinch(const QTouchEvent::TouchPoint& first, const QTouchEvent::TouchPoint& second)
+{
+    m_pinchIds[0] = first.id();
+    m_pinchIds[1] = second.id();
+    m_pinchStartDistance = qMax<qreal>(1.0, QLineF(first.pos(), second.pos()).length());
+    m_pinchStartZoom = 1.0 / m_visibleRect.width();
+    m_pinchAnchor = mapToSource((first.pos() + second.pos()) / 2);
+}
+
+void VideoWidget::updatePinch(const QPointF& first, const QPointF& second)
+{
+    if (m_drawRect.isEmpty() || m_geometrySource.isEmpty())
+    {
+        return;
+    }
+
+    qreal zoom = qBound<qreal>(1.0, m_pinchStartZoom * QLineF(first, second).length() / m_pinchStartDistance, m_maxZoom);
+
+    // 手势开始时两指中点下的远端位置始终保持在当前两指中点下: 缩放围绕手指进行，两指同向移动即平移
+    qreal sourceWidth = m_geometrySource.width();
+    qreal sourceHeight = m_geometrySource.height();
+    qreal scale = m_drawRect.width() * zoom / sourceWidth;
+    QPointF center = (first + second) / 2;
+    QPointF topLeft = m_pinchAnchor - (center - QPointF(m_drawRect.topLeft())) / scale;
+    applyVisibleRect(QRectF(topLeft.x() / sourceWidth, topLeft.y() / sourceHeight, 1.0 / zoom, 1.0 / zoom));
+}
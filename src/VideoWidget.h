@@ -6,6 +6,14 @@
 #include <QMouseEvent>
 #include <QKeyEvent>
 #include <QPushButton>
+#include <QTouchEvent>
+#include <memory>
+
+#include "FrameMailbox.h"
+#include "DeskDefine.h"
+
+class GLVideoRenderer;
+class MultimediaVideoOutput;
 
 class VideoWidget : public QWidget
 {
@@ -14,6 +22,17 @@ class VideoWidget : public QWidget
 public:
     explicit VideoWidget(QWidget* parent = nullptr);
 
+    // 绑定解码线程的最新帧邮箱，收到 onFrameAvailable 时从中取帧
+    void setFrameMailbox(const std::shared_ptr<FrameMailbox>& mailbox);
+    // 临时缩放（尺寸刚变化、解码线程尚未跟上）时是否使用平滑插值
+    void setSmoothScaling(bool smooth);
+    // 选择渲染方式；OpenGL 不可用时回退到光栅绘制。通过 yuvOutputChanged 告知解码线程输出格式
+    void setRenderer(DeskRenderer renderer);
+    // 双指缩放的最大倍数，<= 1 时关闭本地缩放
+    void setMaxZoom(qreal zoom);
+    // 当前可见的源画面区域（归一化坐标），未放大时为 (0, 0, 1, 1)
+    QRectF visibleRect() const { return m_visibleRect; }
+
 signals:
     void mouseEventCaptured(int x, int y, int mask, int value);
     void touchEventCaptured(QVariant value);
@@ -21,8 +40,17 @@ signals:
 
     void closeBtnClicked();
 
+    // 控件尺寸变化，解码线程据此调整缩放目标
+    void targetSizeChanged(const QSize& size);
+    // true: 解码线程应输出 YUV 帧交给 GLVideoRenderer；false: 输出 RGB QImage
+    void yuvOutputChanged(bool enabled);
+    // 双指缩放/平移改变了可见区域，解码线程据此只转换这一块
+    void visibleRectChanged(const QRectF& rect);
+
 public slots:
-    void setFrame(const QImage& image);
+    void setFrame(const QImage& image, const QSize& sourceSize);
+    // 邮箱里有新帧，取出后按变化区域安排重绘
+    void onFrameAvailable();
 
     void setPreValue(const qreal &scale);
 
@@ -38,19 +66,79 @@ protected:
     void keyPressEvent(QKeyEvent* event) override;
     void keyReleaseEvent(QKeyEvent* event) override;
 
+private slots:
+    // YUV 渲染子控件初始化或显示失败，回退到光栅绘制
+    void onYuvViewFailed();
+
 private:
     QImage m_currentFrame;
+    // 远端画面原始分辨率，坐标映射按它计算
+    QSize m_sourceSize;
+    std::shared_ptr<FrameMailbox> m_mailbox;
     bool m_firstFrame = true;
     qreal m_scale = 1.0;
 
-    // 偏移量变量
-    int m_offsetX = 0;
-    int m_offsetY = 0;
+    // 偏移量变量（放大后可见区域左上角不在显示区域左上角，为小数）
+    qreal m_offsetX = 0;
+    qreal m_offsetY = 0;
+
+    // 本地缩放: 可见的源画面区域（归一化，对齐到与解码线程相同的偶数像素），以及当前帧覆盖的区域
+    // 解码线程按新区域转换出来之前，旧帧按它自己的区域摆放，手势跟手
+    QRectF m_visibleRect = QRectF(0, 0, 1, 1);
+    QRectF m_imageRect = QRectF(0, 0, 1, 1);
+    qreal m_maxZoom = 4.0;
+    // 双指手势状态: 起始两指的 id、距离、倍数，以及起始中点下的源画面坐标
+    bool m_pinching = false;
+    int m_pinchIds[2] = { -1, -1 };
+    qreal m_pinchStartDistance = 1.0;
+    qreal m_pinchStartZoom = 1.0;
+    QPointF m_pinchAnchor;
+    // 已有触摸点发给了远端、尚未结束
+    bool m_touchForwarded = false;
 
     QPoint m_hoverPt = QPoint(0, 0);
 
+    // 两次汇总显示延迟之间的绘制次数
+    int m_paintCount = 0;
+
+    // 显示延迟统计（收包到上屏、解码完成到上屏）
+    qint64 m_latencyNs = 0;
+    qint64 m_queueLatencyNs = 0;
+    int m_latencyCount = 0;
+
+    // 显示区域缓存，只在控件尺寸或远端分辨率变化时重新计算
+    QRect m_drawRect;
+    QSize m_geometrySize;
+    QSize m_geometrySource;
+    bool m_smoothScaling = true;
+
+    // 按当前控件尺寸和 m_sourceSize 更新 m_drawRect、m_scale 和偏移，返回显示区域是否变化
+    bool updateDrawRect();
+    // 按 m_drawRect 和可见区域更新 m_scale 和偏移
+    void updateViewTransform();
+    // 控件坐标 -> 远端画面坐标，鼠标和触摸共用
+    QPointF mapToSource(const QPointF& pos) const;
+    // 当前帧在控件中的位置（放大时可能超出显示区域）
+    QRectF imageTarget() const;
+    // 夹到画面内、对齐后设为可见区域，通知渲染器和解码线程
+    void applyVisibleRect(const QRectF& rect);
+    // 记录从邮箱取到的帧和显示延迟
+    void acceptFrame(const VideoFrame& frame);
+
+    void destroyYuvView();
+
+    // 显示 YUV 帧的子控件（GLVideoRenderer 或 QVideoWidget），覆盖 m_drawRect；光栅绘制时为空
+    QWidget* m_yuvView = nullptr;
+    GLVideoRenderer* m_glRenderer = nullptr;
+    MultimediaVideoOutput* m_multimediaOutput = nullptr;
+
     void handleMouseEvent(QPointF pos, int mask, int value);
     bool handleTouchEvent(QTouchEvent* event);
+    // 两指及以上的触摸在本地做缩放/平移，返回 true 表示事件已消费、不发给远端
+    bool handlePinch(QTouchEvent* event);
+    void beginPinch(const QTouchEvent::TouchPoint& first, const QTouchEvent::TouchPoint& second);
+    void updatePinch(const QPointF& first, const QPointF& second);
+    void emitTouchPoints(const QList<QTouchEvent::TouchPoint>& touchPoints, DeskTouchPhase phase);
 
     QPushButton *m_closeBtn = nullptr;
 };
@@ -0,0 +1,525 @@
+#include "YuvConverter.h"
+
+#include <cstddef>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define YUV_HAVE_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define YUV_TARGET(x)
+#else
+#define YUV_TARGET(x) __attribute__((target(x)))
+#endif
+#endif
+
+#if defined(__aarch64__) || (defined(__arm__) && defined(__ARM_NEON))
+#define YUV_HAVE_NEON 1
+#include <arm_neon.h>
+#if defined(__arm__) && defined(__linux__)
+#include <sys/auxv.h>
+#endif
+#endif
+
+// BT.601 有限范围:
+// R = 1.164(Y-16) + 1.596(V-128)
+// G = 1.164(Y-16) - 0.392(U-128) - 0.813(V-128)
+// B = 1.164(Y-16) + 2.017(U-128)
+// 中间结果带 6 位小数（int16 内），系数按 15 位小数取高半乘积（mulhi）:
+//   term = (x << 6) * 整数部分 + ((x << 7) * 小数部分系数) >> 16
+// 大于 1 的系数拆成整数部分（移位）加小数部分，小数部分系数都不超过 int16。
+// 相对浮点参考的误差不超过 1，Y=235 白色得到 255。
+// 除 B 通道可能在 SIMD 中饱和（饱和后仍被截到 255）外中间值都落在 int16 内，
+// 且高半乘积按向下取整，因此标量与 SIMD 结果逐位一致
+#define YUV_COEF_Y  5387    // 0.164383 (1.164383 - 1)
+#define YUV_COEF_RV 19531   // 0.596027 (1.596027 - 1)
+#define YUV_COEF_GU 12837   // 0.391762
+#define YUV_COEF_GV 26639   // 0.812968
+#define YUV_COEF_BU 565     // 0.017232 (2.017232 - 2)
+#define YUV_ROUND   32
+#define YUV_SHIFT   6
+
+// 行函数: 从第 x 个像素开始转换一行，返回已处理到的像素位置
+typedef int (*YuvRowFunc)(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                          uint8_t* dst, int x, int width);
+
+static inline uint8_t clampToByte(int value)
+{
+    return static_cast<uint8_t>(value < 0 ? 0 : (value > 255 ? 255 : value));
+}
+
+// 与 _mm_mulhi_epi16 相同: 有符号乘积的高 16 位（向下取整）
+static inline int mulhi16(int a, int b)
+{
+    return (a * b) >> 16;
+}
+
+// ==========================================
+// 标量参考实现
+// ==========================================
+template <bool NV12, bool RGB565>
+static int yuvRowScalar(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                        uint8_t* dst, int x, int width)
+{
+    for (; x < width; ++x)
+    {
+        int cx = x >> 1;
+        int U = (NV12 ? u[cx * 2] : u[cx]) - 128;
+        int V = (NV12 ? u[cx * 2 + 1] : v[cx]) - 128;
+        int Y = y[x] - 16;
+        int yc = Y * 64 + mulhi16(Y * 128, YUV_COEF_Y) + YUV_ROUND;
+        int rv = V * 64 + mulhi16(V * 128, YUV_COEF_RV);
+        int gc = mulhi16(U * 128, YUV_COEF_GU) + mulhi16(V * 128, YUV_COEF_GV);
+        int bu = U * 128 + mulhi16(U * 128, YUV_COEF_BU);
+
+        uint8_t r = clampToByte((yc + rv) >> YUV_SHIFT);
+        uint8_t g = clampToByte((yc - gc) >> YUV_SHIFT);
+        uint8_t b = clampToByte((yc + bu) >> YUV_SHIFT);
+
+        if (RGB565)
+        {
+            uint16_t pixel = static_cast<uint16_t>(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+            dst[x * 2] = static_cast<uint8_t>(pixel & 0xFF);
+            dst[x * 2 + 1] = static_cast<uint8_t>(pixel >> 8);
+        }
+        else
+        {
+            dst[x * 4] = b;
+            dst[x * 4 + 1] = g;
+            dst[x * 4 + 2] = r;
+            dst[x * 4 + 3] = 0xFF;
+        }
+    }
+    return x;
+}
+
+// ==========================================
+// x86: SSE4.1 / AVX2
+// ==========================================
+#ifdef YUV_HAVE_X86
+
+// 取 16 个像素对应的 8 个 U、8 个 V（低 64 位有效）
+template <bool NV12>
+YUV_TARGET("sse4.1")
+static inline void loadChromaSSE(const uint8_t* u, const uint8_t* v, int x, __m128i& u8, __m128i& v8)
+{
+    if (NV12)
+    {
+        const __m128i evenMask = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, -1, -1, -1, -1, -1, -1, -1, -1);
+        const __m128i oddMask = _mm_setr_epi8(1, 3, 5, 7, 9, 11, 13, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+        __m128i uv = _mm_loadu_si128(reinterpret_cast<const __m128i*>(u + x));
+        u8 = _mm_shuffle_epi8(uv, evenMask);
+        v8 = _mm_shuffle_epi8(uv, oddMask);
+    }
+    else
+    {
+        u8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(u + x / 2));
+        v8 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(v + x / 2));
+    }
+}
+
+// 写出 16 个像素
+template <bool RGB565>
+YUV_TARGET("sse4.1")
+static inline void storePixelsSSE(uint8_t* dst, int x, __m128i r8, __m128i g8, __m128i b8)
+{
+    if (RGB565)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i maskR = _mm_set1_epi16(static_cast<short>(0xF800));
+        const __m128i maskG = _mm_set1_epi16(0x07E0);
+        __m128i out[2];
+        for (int half = 0; half < 2; ++half)
+        {
+            __m128i r16 = half ? _mm_unpackhi_epi8(r8, zero) : _mm_unpacklo_epi8(r8, zero);
+            __m128i g16 = half ? _mm_unpackhi_epi8(g8, zero) : _mm_unpacklo_epi8(g8, zero);
+            __m128i b16 = half ? _mm_unpackhi_epi8(b8, zero) : _mm_unpacklo_epi8(b8, zero);
+            out[half] = _mm_or_si128(_mm_or_si128(_mm_and_si128(_mm_slli_epi16(r16, 8), maskR),
+                                                  _mm_and_si128(_mm_slli_epi16(g16, 3), maskG)),
+                                     _mm_srli_epi16(b16, 3));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2), out[0]);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + x * 2 + 16), out[1]);
+    }
+    else
+    {
+        const __m128i alpha = _mm_set1_epi8(static_cast<char>(0xFF));
+        __m128i bgLo = _mm_unpacklo_epi8(b8, g8);
+        __m128i bgHi = _mm_unpackhi_epi8(b8, g8);
+        __m128i raLo = _mm_unpacklo_epi8(r8, alpha);
+        __m128i raHi = _mm_unpackhi_epi8(r8, alpha);
+        __m128i* out = reinterpret_cast<__m128i*>(dst + x * 4);
+        _mm_storeu_si128(out, _mm_unpacklo_epi16(bgLo, raLo));
+        _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(bgLo, raLo));
+        _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(bgHi, raHi));
+        _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(bgHi, raHi));
+    }
+}
+
+template <bool NV12, bool RGB565>
+YUV_TARGET("sse4.1")
+static int yuvRowSSE41(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                       uint8_t* dst, int x, int width)
+{
+    const __m128i c16 = _mm_set1_epi16(16);
+    const __m128i c128 = _mm_set1_epi16(128);
+    const __m128i cY = _mm_set1_epi16(YUV_COEF_Y);
+    const __m128i cRound = _mm_set1_epi16(YUV_ROUND);
+    const __m128i cRV = _mm_set1_epi16(YUV_COEF_RV);
+    const __m128i cGU = _mm_set1_epi16(YUV_COEF_GU);
+    const __m128i cGV = _mm_set1_epi16(YUV_COEF_GV);
+    const __m128i cBU = _mm_set1_epi16(YUV_COEF_BU);
+
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i u8, v8;
+        loadChromaSSE<NV12>(u, v, x, u8, v8);
+
+        __m128i u7 = _mm_slli_epi16(_mm_sub_epi16(_mm_cvtepu8_epi16(u8), c128), 7);
+        __m128i v7 = _mm_slli_epi16(_mm_sub_epi16(_mm_cvtepu8_epi16(v8), c128), 7);
+        __m128i rv = _mm_add_epi16(_mm_srai_epi16(v7, 1), _mm_mulhi_epi16(v7, cRV));
+        __m128i gc = _mm_add_epi16(_mm_mulhi_epi16(u7, cGU), _mm_mulhi_epi16(v7, cGV));
+        __m128i bu = _mm_add_epi16(u7, _mm_mulhi_epi16(u7, cBU));
+
+        __m128i rgb[3][2];
+        for (int half = 0; half < 2; ++half)
+        {
+            __m128i y7 = _mm_slli_epi16(_mm_sub_epi16(_mm_cvtepu8_epi16(half ? _mm_srli_si128(y8, 8) : y8), c16), 7);
+            __m128i yc = _mm_add_epi16(_mm_add_epi16(_mm_srai_epi16(y7, 1), _mm_mulhi_epi16(y7, cY)), cRound);
+            // 每个色度样本覆盖水平相邻两个像素
+            __m128i rvd = half ? _mm_unpackhi_epi16(rv, rv) : _mm_unpacklo_epi16(rv, rv);
+            __m128i gcd = half ? _mm_unpackhi_epi16(gc, gc) : _mm_unpacklo_epi16(gc, gc);
+            __m128i bud = half ? _mm_unpackhi_epi16(bu, bu) : _mm_unpacklo_epi16(bu, bu);
+            rgb[0][half] = _mm_srai_epi16(_mm_adds_epi16(yc, rvd), YUV_SHIFT);
+            rgb[1][half] = _mm_srai_epi16(_mm_subs_epi16(yc, gcd), YUV_SHIFT);
+            rgb[2][half] = _mm_srai_epi16(_mm_adds_epi16(yc, bud), YUV_SHIFT);
+        }
+
+        storePixelsSSE<RGB565>(dst, x,
+                               _mm_packus_epi16(rgb[0][0], rgb[0][1]),
+                               _mm_packus_epi16(rgb[1][0], rgb[1][1]),
+                               _mm_packus_epi16(rgb[2][0], rgb[2][1]));
+    }
+    return x;
+}
+
+// AVX2: 16 个像素的定点运算放在一个 256 位寄存器里完成，打包后复用 SSE 的写出
+YUV_TARGET("avx2")
+static inline __m128i packToBytesAVX2(__m256i v)
+{
+    // packus 按 128 位通道交错，permute 把两半的有效 8 字节拼到低 128 位
+    __m256i packed = _mm256_packus_epi16(v, v);
+    return _mm256_castsi256_si128(_mm256_permute4x64_epi64(packed, 0x08));
+}
+
+template <bool NV12, bool RGB565>
+YUV_TARGET("avx2")
+static int yuvRowAVX2(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                      uint8_t* dst, int x, int width)
+{
+    const __m256i c16 = _mm256_set1_epi16(16);
+    const __m256i c128 = _mm256_set1_epi16(128);
+    const __m256i cY = _mm256_set1_epi16(YUV_COEF_Y);
+    const __m256i cRound = _mm256_set1_epi16(YUV_ROUND);
+    const __m256i cRV = _mm256_set1_epi16(YUV_COEF_RV);
+    const __m256i cGU = _mm256_set1_epi16(YUV_COEF_GU);
+    const __m256i cGV = _mm256_set1_epi16(YUV_COEF_GV);
+    const __m256i cBU = _mm256_set1_epi16(YUV_COEF_BU);
+
+    for (; x + 16 <= width; x += 16)
+    {
+        __m128i y8 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(y + x));
+        __m128i u8, v8;
+        loadChromaSSE<NV12>(u, v, x, u8, v8);
+
+        // 色度先按字节复制成每像素一份，再扩展为 16 位
+        __m256i u7 = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(u8, u8)), c128), 7);
+        __m256i v7 = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(_mm_unpacklo_epi8(v8, v8)), c128), 7);
+        __m256i y7 = _mm256_slli_epi16(_mm256_sub_epi16(_mm256_cvtepu8_epi16(y8), c16), 7);
+        __m256i yc = _mm256_add_epi16(_mm256_add_epi16(_mm256_srai_epi16(y7, 1), _mm256_mulhi_epi16(y7, cY)), cRound);
+
+        __m256i rv = _mm256_add_epi16(_mm256_srai_epi16(v7, 1), _mm256_mulhi_epi16(v7, cRV));
+        __m256i gc = _mm256_add_epi16(_mm256_mulhi_epi16(u7, cGU), _mm256_mulhi_epi16(v7, cGV));
+        __m256i bu = _mm256_add_epi16(u7, _mm256_mulhi_epi16(u7, cBU));
+        __m256i r = _mm256_srai_epi16(_mm256_adds_epi16(yc, rv), YUV_SHIFT);
+        __m256i g = _mm256_srai_epi16(_mm256_subs_epi16(yc, gc), YUV_SHIFT);
+        __m256i b = _mm256_srai_epi16(_mm256_adds_epi16(yc, bu), YUV_SHIFT);
+
+        storePixelsSSE<RGB565>(dst, x, packToBytesAVX2(r), packToBytesAVX2(g), packToBytesAVX2(b));
+    }
+    return x;
+}
+
+static bool cpuSupportsSSE41()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[2] & (1 << 19)) != 0;
+#else
+    return __builtin_cpu_supports("sse4.1");
+#endif
+}
+
+static bool cpuSupportsAVX2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+    {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // YUV_HAVE_X86
+
+// ==========================================
+// ARM: NEON
+// ==========================================
+#ifdef YUV_HAVE_NEON
+
+template <bool NV12, bool RGB565>
+static int yuvRowNEON(const uint8_t* y, const uint8_t* u, const uint8_t* v,
+                      uint8_t* dst, int x, int width)
+{
+    const int16x8_t c16 = vdupq_n_s16(16);
+    const int16x8_t c128 = vdupq_n_s16(128);
+    const int16x8_t cRound = vdupq_n_s16(YUV_ROUND);
+    const uint8x16_t alpha = vdupq_n_u8(0xFF);
+
+    for (; x + 16 <= width; x += 16)
+    {
+        uint8x16_t y8 = vld1q_u8(y + x);
+        uint8x8_t u8, v8;
+        if (NV12)
+        {
+            uint8x8x2_t uv = vld2_u8(u + x);
+            u8 = uv.val[0];
+            v8 = uv.val[1];
+        }
+        else
+        {
+            u8 = vld1_u8(u + x / 2);
+            v8 = vld1_u8(v + x / 2);
+        }
+
+        // vqdmulhq_s16 是 (2*a*b) >> 16，输入只左移 6 位即与 x86 的 mulhi(x << 7) 相同
+        int16x8_t u6 = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(u8)), c128), 6);
+        int16x8_t v6 = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(v8)), c128), 6);
+        int16x8_t rvs = vaddq_s16(v6, vqdmulhq_n_s16(v6, YUV_COEF_RV));
+        int16x8_t gcs = vaddq_s16(vqdmulhq_n_s16(u6, YUV_COEF_GU), vqdmulhq_n_s16(v6, YUV_COEF_GV));
+        int16x8_t bus = vaddq_s16(vshlq_n_s16(u6, 1), vqdmulhq_n_s16(u6, YUV_COEF_BU));
+        // 每个色度样本覆盖水平相邻两个像素
+        int16x8x2_t rv = vzipq_s16(rvs, rvs);
+        int16x8x2_t gc = vzipq_s16(gcs, gcs);
+        int16x8x2_t bu = vzipq_s16(bus, bus);
+
+        int16x8_t yLo = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(y8))), c16), 6);
+        int16x8_t yHi = vshlq_n_s16(vsubq_s16(vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(y8))), c16), 6);
+        int16x8_t ycLo = vaddq_s16(vaddq_s16(yLo, vqdmulhq_n_s16(yLo, YUV_COEF_Y)), cRound);
+        int16x8_t ycHi = vaddq_s16(vaddq_s16(yHi, vqdmulhq_n_s16(yHi, YUV_COEF_Y)), cRound);
+
+        uint8x16_t r8 = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(ycLo, rv.val[0]), YUV_SHIFT)),
+                                    vqmovun_s16(vshrq_n_s16(vqaddq_s16(ycHi, rv.val[1]), YUV_SHIFT)));
+        uint8x16_t g8 = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqsubq_s16(ycLo, gc.val[0]), YUV_SHIFT)),
+                                    vqmovun_s16(vshrq_n_s16(vqsubq_s16(ycHi, gc.val[1]), YUV_SHIFT)));
+        uint8x16_t b8 = vcombine_u8(vqmovun_s16(vshrq_n_s16(vqaddq_s16(ycLo, bu.val[0]), YUV_SHIFT)),
+                                    vqmovun_s16(vshrq_n_s16(vqaddq_s16(ycHi, bu.val[1]), YUV_SHIFT)));
+
+        if (RGB565)
+        {
+            // R 高 5 位、G 高 6 位、B 高 5 位依次右移插入
+            uint16x8_t lo = vshll_n_u8(vget_low_u8(r8), 8);
+            lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(g8), 8), 5);
+            lo = vsriq_n_u16(lo, vshll_n_u8(vget_low_u8(b8), 8), 11);
+            uint16x8_t hi = vshll_n_u8(vget_high_u8(r8), 8);
+            hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(g8), 8), 5);
+            hi = vsriq_n_u16(hi, vshll_n_u8(vget_high_u8(b8), 8), 11);
+            vst1q_u16(reinterpret_cast<uint16_t*>(dst + x * 2), lo);
+            vst1q_u16(reinterpret_cast<uint16_t*>(dst + x * 2 + 16), hi);
+        }
+        else
+        {
+            uint8x16x4_t bgra;
+            bgra.val[0] = b8;
+            bgra.val[1] = g8;
+            bgra.val[2] = r8;
+            bgra.val[3] = alpha;
+            vst4q_u8(dst + x * 4, bgra);
+        }
+    }
+    return x;
+}
+
+static bool cpuSupportsNEON()
+{
+#if defined(__aarch64__)
+    return true;
+#elif defined(__linux__)
+    // HWCAP_NEON
+    return (getauxval(AT_HWCAP) & (1 << 12)) != 0;
+#else
+    return true;
+#endif
+}
+
+#endif // YUV_HAVE_NEON
+
+template <bool NV12, bool RGB565>
+static YuvRowFunc selectRowFunc(YuvConverter::Kernel kernel)
+{
+    switch (kernel)
+    {
+#ifdef YUV_HAVE_X86
+    case YuvConverter::KernelAVX2:
+        return &yuvRowAVX2<NV12, RGB565>;
+    case YuvConverter::KernelSSE41:
+        return &yuvRowSSE41<NV12, RGB565>;
+#endif
+#ifdef YUV_HAVE_NEON
+    case YuvConverter::KernelNEON:
+        return &yuvRowNEON<NV12, RGB565>;
+#endif
+    default:
+        return &yuvRowScalar<NV12, RGB565>;
+    }
+}
+
+YuvConverter::YuvConverter()
+    : m_kernel(bestKernel())
+{
+}
+
+YuvConverter::YuvConverter(Kernel kernel)
+    : m_kernel(isKernelSupported(kernel) ? kernel : KernelScalar)
+{
+}
+
+bool YuvConverter::isKernelSupported(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case KernelScalar:
+        return true;
+#ifdef YUV_HAVE_X86
+    case KernelSSE41:
+        return cpuSupportsSSE41();
+    case KernelAVX2:
+        return cpuSupportsAVX2();
+#endif
+#ifdef YUV_HAVE_NEON
+    case KernelNEON:
+        return cpuSupportsNEON();
+#endif
+    default:
+        return false;
+    }
+}
+
+YuvConverter::Kernel YuvConverter::bestKernel()
+{
+    static const Kernel best = []() {
+        const Kernel order[] = { KernelAVX2, KernelSSE41, KernelNEON };
+        for (Kernel kernel : order)
+        {
+            if (isKernelSupported(kernel))
+            {
+                return kernel;
+            }
+        }
+        return KernelScalar;
+    }();
+    return best;
+}
+
+const char* YuvConverter::kernelName(Kernel kernel)
+{
+    switch (kernel)
+    {
+    case KernelSSE41:
+        return "sse4.1";
+    case KernelAVX2:
+        return "avx2";
+    case KernelNEON:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+
+bool YuvConverter::supports(const AVFrame* frame, AVPixelFormat dstFormat)
+{
+    if (!frame || frame->color_range == AVCOL_RANGE_JPEG)
+    {
+        return false;
+    }
+    if (frame->format != AV_PIX_FMT_YUV420P && frame->format != AV_PIX_FMT_NV12)
+    {
+        return false;
+    }
+    return dstFormat == AV_PIX_FMT_BGRA || dstFormat == AV_PIX_FMT_RGB565LE;
+}
+
+void YuvConverter::convert(const AVFrame* frame, AVPixelFormat dstFormat,
+                           uint8_t* dst, int dstStride, int rowBegin, int rowEnd) const
+{
+    bool nv12 = frame->format == AV_PIX_FMT_NV12;
+    convertRows(frame->data[0], frame->linesize[0],
+                frame->data[1], frame->linesize[1],
+                nv12 ? nullptr : frame->data[2], nv12 ? 0 : frame->linesize[2], nv12,
+                dst, dstStride, dstFormat == AV_PIX_FMT_RGB565LE,
+                frame->width, rowBegin, rowEnd);
+}
+
+void YuvConverter::convertRows(const uint8_t* srcY, int strideY,
+                               const uint8_t* srcU, int strideU,
+                               const uint8_t* srcV, int strideV, bool nv12,
+                               uint8_t* dst, int dstStride, bool rgb565,
+                               int width, int rowBegin, int rowEnd) const
+{
+    YuvRowFunc simd;
+    YuvRowFunc scalar;
+    if (nv12)
+    {
+        simd = rgb565 ? selectRowFunc<true, true>(m_kernel) : selectRowFunc<true, false>(m_kernel);
+        scalar = rgb565 ? &yuvRowScalar<true, true> : &yuvRowScalar<true, false>;
+    }
+    else
+    {
+        simd = rgb565 ? selectRowFunc<false, true>(m_kernel) : selectRowFunc<false, false>(m_kernel);
+        scalar = rgb565 ? &yuvRowScalar<false, true> : &yuvRowScalar<false, false>;
+    }
+
+    for (int row = rowBegin; row < rowEnd; ++row)
+    {
+        const uint8_t* y = srcY + static_cast<ptrdiff_t>(row) * strideY;
+        const uint8_t* u = srcU + static_cast<ptrdiff_t>(row >> 1) * strideU;
+        const uint8_t* v = srcV ? srcV + static_cast<ptrdiff_t>(row >> 1) * strideV : nullptr;
+        uint8_t* out = dst + static_cast<ptrdiff_t>(row) * dstStride;
+
+        // SIMD 处理 16 像素对齐的主体，行尾不足 16 个像素交给标量
+        int x = simd(y, u, v, out, 0, width);
+        if (x < width)
+        {
+            scalar(y, u, v, out, x, width);
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#ifndef YUVCONVERTER_H
+#define YUVCONVERTER_H
+
+#include <cstdint>
+
+extern "C" {
+#include <libavutil/pixfmt.h>
+}
+
+struct AVFrame;
+
+// 同尺寸 YUV420P/NV12 -> BGRA/RGB565 色彩转换
+// sws_scale 在不缩放时仍要走缩放器框架，这里用专用内核直接转换:
+// 标量参考实现 + SSE4.1/AVX2(x86) + NEON(ARM)，运行时按 CPU 特性选择。
+// 各 SIMD 内核与标量实现使用同一套 16 位定点运算，结果逐位一致。
+// 系数为 BT.601 有限范围（H.264 未声明色彩空间时的默认值）。
+class YuvConverter
+{
+public:
+    enum Kernel
+    {
+        KernelScalar = 0,
+        KernelSSE41,
+        KernelAVX2,
+        KernelNEON
+    };
+
+    YuvConverter();
+    explicit YuvConverter(Kernel kernel);
+
+    // 当前 CPU 可用的最快内核
+    static Kernel bestKernel();
+    static bool isKernelSupported(Kernel kernel);
+    static const char* kernelName(Kernel kernel);
+
+    Kernel kernel() const { return m_kernel; }
+
+    // 是否能处理该源/目标格式组合（全范围 YUVJ 等交给 sws_scale）
+    static bool supports(const AVFrame* frame, AVPixelFormat dstFormat);
+
+    // 转换 [rowBegin, rowEnd) 行，dst 指向第 0 行
+    // 各行互不依赖，可按行切片并行调用
+    void convert(const AVFrame* frame, AVPixelFormat dstFormat,
+                 uint8_t* dst, int dstStride, int rowBegin, int rowEnd) const;
+
+    // 与 AVFrame 无关的底层接口，nv12 时 srcU 为交错 UV 平面，srcV 忽略
+    void convertRows(const uint8_t* srcY, int strideY,
+                     const uint8_t* srcU, int strideU,
+                     const uint8_t* srcV, int strideV, bool nv12,
+                     uint8_t* dst, int dstStride, bool rgb565,
+                     int width, int rowBegin, int rowEnd) const;
+
+private:
+    Kernel m_kernel = KernelScalar;
+};
+
+#endif // YUVCONVERTER_H
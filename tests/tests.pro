@@ -0,0 +1,9 @@
+# 单元测试，与 src/DeskControler.pro 独立构建:
+#   qmake tests/tests.pro && make && make check
+
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_yuvconverter \
+    tst_glvideorenderer \
+    tst_accessunitassembler
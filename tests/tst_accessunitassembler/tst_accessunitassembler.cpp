@@ -0,0 +1,121 @@
+#include <QtTest>
+
+#include "AccessUnitAssembler.h"
+#include "H264Nal.h"
+
+// 测试码流里 IDR 片的负载长度，足够在中间任意位置拆开
+#define IDR_PAYLOAD_SIZE 600
+#define P_PAYLOAD_SIZE 120
+
+// 一个带四字节起始码的 NAL: 头字节、片头首字节（first_mb_in_slice == 0 时最高位为 1），其后为负载
+// 负载不含 0，不会出现伪起始码；线性同余保证每次运行数据一致
+static QByteArray makeNal(uint8_t header, int payloadSize, quint32 seed)
+{
+    QByteArray nal("\x00\x00\x00\x01", 4);
+    nal.append(static_cast<char>(header));
+    quint32 state = seed;
+    for (int i = 0; i < payloadSize; ++i)
+    {
+        state = state * 1664525u + 1013904223u;
+        nal.append(static_cast<char>(i == 0 ? 0x88 : 0x10 + (state >> 24) % 0xE0));
+    }
+    return nal;
+}
+
+// SPS + PPS + IDR 片，一帧
+static QByteArray makeIdrFrame()
+{
+    return makeNal(0x67, 8, 1) + makeNal(0x68, 4, 2) + makeNal(0x65, IDR_PAYLOAD_SIZE, 3);
+}
+
+// 单片的 P 帧
+static QByteArray makePFrame(quint32 seed)
+{
+    return makeNal(0x41, P_PAYLOAD_SIZE, seed);
+}
+
+static QVector<int> nalTypes(const AccessUnit& unit)
+{
+    QVector<int> types;
+    for (const NalUnit& nal : unit.nals)
+    {
+        types.append(nal.type);
+    }
+    return types;
+}
+
+class tst_AccessUnitAssembler : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void idrSplitAcrossMessages_data();
+    void idrSplitAcrossMessages();
+    void wholeFramesPerMessage_data();
+    void wholeFramesPerMessage();
+};
+
+void tst_AccessUnitAssembler::idrSplitAcrossMessages_data()
+{
+    QTest::addColumn<int>("split");
+    int idrStart = makeIdrFrame().size() - IDR_PAYLOAD_SIZE - 5;
+    QTest::newRow("in start code") << idrStart + 2;
+    QTest::newRow("after header") << idrStart + 5;
+    QTest::newRow("mid payload") << idrStart + 5 + IDR_PAYLOAD_SIZE / 2;
+    QTest::newRow("last byte") << makeIdrFrame().size() - 1;
+}
+
+// 默认模式下，IDR 片在中间被拆到两条消息里，解码器收到的仍是完整的一帧
+void tst_AccessUnitAssembler::idrSplitAcrossMessages()
+{
+    QFETCH(int, split);
+    QByteArray idr = makeIdrFrame();
+    QByteArray next = makePFrame(4);
+
+    AccessUnitAssembler assembler(DeskVideoConfig().accessUnitMode, VIDEO_CODEC_H264);
+    QVector<AccessUnit> units;
+    assembler.push(idr.left(split), units);
+    assembler.push(idr.mid(split), units);
+    QVERIFY2(units.isEmpty(), "a unit was emitted before the frame was complete");
+
+    // 下一帧开始时才输出
+    assembler.push(next, units);
+    QCOMPARE(units.size(), 1);
+    QCOMPARE(units[0].data, idr);
+    QCOMPARE(nalTypes(units[0]), QVector<int>({ H264_NAL_SPS, H264_NAL_PPS, H264_NAL_IDR_SLICE }));
+    QCOMPARE(units[0].nals.last().size, IDR_PAYLOAD_SIZE + 1);
+    QCOMPARE(assembler.mergedCount(), quint64(1));
+    QCOMPARE(assembler.pendingBytes(), next.size());
+}
+
+void tst_AccessUnitAssembler::wholeFramesPerMessage_data()
+{
+    QTest::addColumn<int>("mode");
+    QTest::newRow("message") << int(AU_MODE_MESSAGE);
+    QTest::newRow("frame") << int(AU_MODE_FRAME);
+}
+
+// 每条消息一帧时两种模式输出相同的单元: 消息模式立即输出，帧模式晚一条消息
+void tst_AccessUnitAssembler::wholeFramesPerMessage()
+{
+    QFETCH(int, mode);
+    const QByteArray frames[] = { makeIdrFrame(), makePFrame(5), makePFrame(6) };
+
+    AccessUnitAssembler assembler(static_cast<DeskAccessUnitMode>(mode), VIDEO_CODEC_H264);
+    QVector<AccessUnit> units;
+    for (const QByteArray& frame : frames)
+    {
+        assembler.push(frame, units);
+    }
+    int expected = mode == AU_MODE_MESSAGE ? 3 : 2;
+    QCOMPARE(units.size(), expected);
+    for (int i = 0; i < expected; ++i)
+    {
+        QCOMPARE(units[i].data, frames[i]);
+    }
+    QCOMPARE(assembler.pendingBytes(), mode == AU_MODE_MESSAGE ? 0 : frames[2].size());
+}
+
+QTEST_APPLESS_MAIN(tst_AccessUnitAssembler)
+
+#include "tst_accessunitassembler.moc"
@@ -0,0 +1,19 @@
+QT += testlib widgets
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_accessunitassembler
+
+INCLUDEPATH += $$PWD/../../src
+
+# AccessUnitAssembler 识别编码格式时写日志，测试里不会创建 LogWidget，只为链接
+HEADERS += \
+    $$PWD/../../src/LogWidget.h
+
+SOURCES += \
+    tst_accessunitassembler.cpp \
+    $$PWD/../../src/AccessUnitAssembler.cpp \
+    $$PWD/../../src/H264Nal.cpp \
+    $$PWD/../../src/LogWidget.cpp \
+    $$PWD/../../src/StreamParser.cpp
@@ -0,0 +1,269 @@
+#include <QtTest>
+#include <QGuiApplication>
+#include <QOffscreenSurface>
+#include <QOpenGLContext>
+#include <QOpenGLFramebufferObject>
+
+#include "GLYuvProgram.h"
+#include "YuvConverter.h"
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+extern "C" {
+#include <libavutil/frame.h>
+}
+
+// 各平面行尾的填充字节数，模拟解码器的对齐
+#define STRIDE_PADDING 32
+// GPU 与 CPU 路径每个通道允许的差: 着色器系数只有三位小数，且 GPU 的取整方式不同
+#define MAX_CHANNEL_DIFF 2
+// 边缘测试的放大倍数，放大后双线性采样点会落到最后一个有效像素中心之外
+#define EDGE_UPSCALE 3
+
+// 一帧测试用的 YUV420P/NV12 数据，有效区域之外的行尾填充写入与有效内容反差最大的值
+struct TestFrame
+{
+    std::vector<uint8_t> planes[3];
+    std::unique_ptr<AVFrame, void (*)(AVFrame*)> frame{ av_frame_alloc(), [](AVFrame* f) { av_frame_free(&f); } };
+
+    TestFrame(int width, int height, bool nv12)
+    {
+        int chromaWidth = (width + 1) / 2;
+        int chromaHeight = (height + 1) / 2;
+        AVFrame* f = frame.get();
+        f->width = width;
+        f->height = height;
+        f->format = nv12 ? AV_PIX_FMT_NV12 : AV_PIX_FMT_YUV420P;
+        f->color_range = AVCOL_RANGE_MPEG;
+        f->linesize[0] = width + STRIDE_PADDING;
+        f->linesize[1] = (nv12 ? chromaWidth * 2 : chromaWidth) + STRIDE_PADDING;
+        f->linesize[2] = nv12 ? 0 : chromaWidth + STRIDE_PADDING;
+        planes[0].assign(static_cast<size_t>(f->linesize[0]) * height, 0);
+        planes[1].assign(static_cast<size_t>(f->linesize[1]) * chromaHeight, 0);
+        planes[2].assign(static_cast<size_t>(f->linesize[2]) * chromaHeight, 0);
+        for (int i = 0; i < 3; ++i)
+        {
+            f->data[i] = planes[i].empty() ? nullptr : planes[i].data();
+        }
+    }
+
+    bool nv12() const { return frame->format == AV_PIX_FMT_NV12; }
+    int chromaWidth() const { return (frame->width + 1) / 2; }
+    int chromaHeight() const { return (frame->height + 1) / 2; }
+
+    uint8_t& lumaAt(int x, int row) { return frame->data[0][row * frame->linesize[0] + x]; }
+    uint8_t& uAt(int cx, int crow)
+    {
+        return nv12() ? frame->data[1][crow * frame->linesize[1] + cx * 2] : frame->data[1][crow * frame->linesize[1] + cx];
+    }
+    uint8_t& vAt(int cx, int crow)
+    {
+        return nv12() ? frame->data[1][crow * frame->linesize[1] + cx * 2 + 1] : frame->data[2][crow * frame->linesize[2] + cx];
+    }
+
+    // 有效区域随机，线性同余保证每次运行数据一致
+    void fillRandom(quint32 seed)
+    {
+        quint32 state = seed;
+        auto next = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<uint8_t>(state >> 24);
+        };
+        for (int row = 0; row < frame->height; ++row)
+            for (int x = 0; x < frame->width; ++x)
+                lumaAt(x, row) = next();
+        for (int crow = 0; crow < chromaHeight(); ++crow)
+        {
+            for (int cx = 0; cx < chromaWidth(); ++cx)
+            {
+                uAt(cx, crow) = next();
+                vAt(cx, crow) = next();
+            }
+        }
+    }
+
+    // 有效区域为单色，行尾填充为 Y=0 U=255 V=0，混入一点就会偏色
+    void fillConstantWithHostilePadding(uint8_t yValue, uint8_t uValue, uint8_t vValue)
+    {
+        std::fill(planes[0].begin(), planes[0].end(), 0);
+        std::fill(planes[1].begin(), planes[1].end(), nv12() ? 0 : 255);
+        std::fill(planes[2].begin(), planes[2].end(), 0);
+        if (nv12())
+        {
+            for (int crow = 0; crow < chromaHeight(); ++crow)
+                for (int cx = chromaWidth(); cx < frame->linesize[1] / 2; ++cx)
+                    uAt(cx, crow) = 255;
+        }
+        for (int row = 0; row < frame->height; ++row)
+            for (int x = 0; x < frame->width; ++x)
+                lumaAt(x, row) = yValue;
+        for (int crow = 0; crow < chromaHeight(); ++crow)
+        {
+            for (int cx = 0; cx < chromaWidth(); ++cx)
+            {
+                uAt(cx, crow) = uValue;
+                vAt(cx, crow) = vValue;
+            }
+        }
+    }
+};
+
+// CPU 路径（标量内核）转换整帧，输出 BGRA，与 QImage::Format_RGB32 内存布局相同
+static QImage convertOnCpu(TestFrame& test)
+{
+    const AVFrame* f = test.frame.get();
+    QImage image(f->width, f->height, QImage::Format_RGB32);
+    YuvConverter converter(YuvConverter::KernelScalar);
+    converter.convertRows(f->data[0], f->linesize[0], f->data[1], f->linesize[1],
+                          f->data[2], f->linesize[2], test.nv12(),
+                          image.bits(), static_cast<int>(image.bytesPerLine()), false, f->width, 0, f->height);
+    return image;
+}
+
+static const int TEST_SIZES[][2] = {
+    { 2, 2 }, { 3, 5 }, { 16, 9 }, { 17, 9 }, { 33, 17 }, { 65, 33 }, { 127, 31 }
+};
+
+class tst_GLVideoRenderer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void matchesCpuPath_data();
+    void matchesCpuPath();
+    void edgeDoesNotSamplePadding_data();
+    void edgeDoesNotSamplePadding();
+
+private:
+    // 上传一帧并画到 viewSize 的离屏 FBO，返回读回的画面
+    QImage render(TestFrame& test, const QSize& viewSize, bool smooth);
+
+    QOffscreenSurface m_surface;
+    QOpenGLContext m_context;
+    GLYuvProgram m_program;
+};
+
+void tst_GLVideoRenderer::initTestCase()
+{
+    m_surface.create();
+    QVERIFY2(m_context.create(), "could not create an OpenGL context");
+    QVERIFY2(m_context.makeCurrent(&m_surface), "could not make the OpenGL context current");
+    qInfo("%s, %s", reinterpret_cast<const char*>(m_context.functions()->glGetString(GL_RENDERER)),
+          reinterpret_cast<const char*>(m_context.functions()->glGetString(GL_VERSION)));
+    QVERIFY2(m_program.initialize(), qPrintable(m_program.log()));
+}
+
+void tst_GLVideoRenderer::cleanupTestCase()
+{
+    if (m_context.makeCurrent(&m_surface))
+    {
+        m_program.destroy();
+        m_context.doneCurrent();
+    }
+}
+
+QImage tst_GLVideoRenderer::render(TestFrame& test, const QSize& viewSize, bool smooth)
+{
+    QOpenGLFramebufferObject fbo(viewSize);
+    if (!fbo.isValid())
+    {
+        return QImage();
+    }
+    fbo.bind();
+    m_program.upload(test.frame.get());
+    m_program.draw(viewSize.width(), viewSize.height(), QRectF(0, 0, 1, 1), smooth);
+    QImage image = fbo.toImage().convertToFormat(QImage::Format_RGB32);
+    fbo.release();
+    return image;
+}
+
+static void addFormatRows()
+{
+    QTest::addColumn<bool>("nv12");
+    QTest::newRow("i420") << false;
+    QTest::newRow("nv12") << true;
+}
+
+void tst_GLVideoRenderer::matchesCpuPath_data()
+{
+    addFormatRows();
+}
+
+// 1:1 最近邻采样时每个像素与 CPU 路径一致（奇数宽高也不能错位一个色度样本）
+void tst_GLVideoRenderer::matchesCpuPath()
+{
+    QFETCH(bool, nv12);
+    for (const auto& size : TEST_SIZES)
+    {
+        TestFrame test(size[0], size[1], nv12);
+        test.fillRandom(static_cast<quint32>(size[0] * 131 + size[1]));
+        QImage gpu = render(test, QSize(size[0], size[1]), false);
+        QVERIFY2(!gpu.isNull(), "could not create a framebuffer object");
+        QImage cpu = convertOnCpu(test);
+        for (int row = 0; row < size[1]; ++row)
+        {
+            const QRgb* g = reinterpret_cast<const QRgb*>(gpu.constScanLine(row));
+            const QRgb* c = reinterpret_cast<const QRgb*>(cpu.constScanLine(row));
+            for (int x = 0; x < size[0]; ++x)
+            {
+                int diff = qMax(qAbs(qRed(g[x]) - qRed(c[x])),
+                                qMax(qAbs(qGreen(g[x]) - qGreen(c[x])), qAbs(qBlue(g[x]) - qBlue(c[x]))));
+                QVERIFY2(diff <= MAX_CHANNEL_DIFF,
+                         qPrintable(QString("%1x%2 (%3,%4): gpu %5, cpu %6")
+                                        .arg(size[0]).arg(size[1]).arg(x).arg(row)
+                                        .arg(g[x] & 0xFFFFFF, 6, 16, QChar('0'))
+                                        .arg(c[x] & 0xFFFFFF, 6, 16, QChar('0'))));
+            }
+        }
+    }
+}
+
+void tst_GLVideoRenderer::edgeDoesNotSamplePadding_data()
+{
+    addFormatRows();
+}
+
+// 放大并双线性采样时，右边缘不能混入行尾填充: 单色画面放大后仍是同一颜色
+void tst_GLVideoRenderer::edgeDoesNotSamplePadding()
+{
+    QFETCH(bool, nv12);
+    for (const auto& size : TEST_SIZES)
+    {
+        TestFrame test(size[0], size[1], nv12);
+        test.fillConstantWithHostilePadding(180, 90, 160);
+        QRgb expected = convertOnCpu(test).pixel(0, 0);
+        QSize viewSize(size[0] * EDGE_UPSCALE, size[1] * EDGE_UPSCALE);
+        QImage gpu = render(test, viewSize, true);
+        QVERIFY2(!gpu.isNull(), "could not create a framebuffer object");
+        for (int row = 0; row < viewSize.height(); ++row)
+        {
+            const QRgb* g = reinterpret_cast<const QRgb*>(gpu.constScanLine(row));
+            for (int x = 0; x < viewSize.width(); ++x)
+            {
+                int diff = qMax(qAbs(qRed(g[x]) - qRed(expected)),
+                                qMax(qAbs(qGreen(g[x]) - qGreen(expected)), qAbs(qBlue(g[x]) - qBlue(expected))));
+                QVERIFY2(diff <= MAX_CHANNEL_DIFF,
+                         qPrintable(QString("%1x%2 view (%3,%4): gpu %5, expected %6")
+                                        .arg(size[0]).arg(size[1]).arg(x).arg(row)
+                                        .arg(g[x] & 0xFFFFFF, 6, 16, QChar('0'))
+                                        .arg(expected & 0xFFFFFF, 6, 16, QChar('0'))));
+            }
+        }
+    }
+}
+
+// 需要窗口系统: 在无显示的构建机上用 xvfb-run 运行。
+// 强制 Mesa 使用 llvmpipe 软件光栅，结果与构建机的显卡驱动无关。
+int main(int argc, char* argv[])
+{
+    qputenv("LIBGL_ALWAYS_SOFTWARE", "1");
+    QGuiApplication app(argc, argv);
+    tst_GLVideoRenderer test;
+    return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_glvideorenderer.moc"
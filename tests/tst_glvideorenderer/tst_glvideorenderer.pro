@@ -0,0 +1,15 @@
+QT += testlib gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_glvideorenderer
+
+INCLUDEPATH += $$PWD/../../src
+
+SOURCES += \
+    tst_glvideorenderer.cpp \
+    $$PWD/../../src/GLYuvProgram.cpp \
+    $$PWD/../../src/YuvConverter.cpp
+
+include($$PWD/../../3rdpart/ffmpeg/ffmpeg.pri)
@@ -0,0 +1,294 @@
+#include <QtTest>
+
+#include "YuvConverter.h"
+
+#include <cmath>
+#include <vector>
+
+// 目标缓冲每行末尾留出的哨兵字节，检查内核没有写出行宽之外
+#define GUARD_BYTES 64
+#define GUARD_VALUE 0xA5
+
+// 一帧测试用的 YUV420P/NV12 平面，各平面行距都比宽度大，模拟解码器的对齐填充
+struct TestPlanes
+{
+    int width = 0;
+    int height = 0;
+    bool nv12 = false;
+    int strideY = 0;
+    int strideC = 0;
+    std::vector<uint8_t> y;
+    std::vector<uint8_t> u;
+    std::vector<uint8_t> v;
+
+    TestPlanes(int w, int h, bool isNv12)
+        : width(w), height(h), nv12(isNv12)
+    {
+        int chromaWidth = (w + 1) / 2;
+        int chromaHeight = (h + 1) / 2;
+        strideY = w + 32;
+        strideC = (nv12 ? chromaWidth * 2 : chromaWidth) + 32;
+        y.assign(static_cast<size_t>(strideY) * h, 0);
+        u.assign(static_cast<size_t>(strideC) * chromaHeight, 0);
+        v.assign(nv12 ? 0 : static_cast<size_t>(strideC) * chromaHeight, 0);
+    }
+
+    uint8_t& lumaAt(int x, int row) { return y[static_cast<size_t>(row) * strideY + x]; }
+    uint8_t& uAt(int cx, int crow) { return nv12 ? u[static_cast<size_t>(crow) * strideC + cx * 2] : u[static_cast<size_t>(crow) * strideC + cx]; }
+    uint8_t& vAt(int cx, int crow) { return nv12 ? u[static_cast<size_t>(crow) * strideC + cx * 2 + 1] : v[static_cast<size_t>(crow) * strideC + cx]; }
+
+    void fillRandom(quint32 seed)
+    {
+        // 线性同余，保证每次运行数据一致
+        quint32 state = seed;
+        auto next = [&state]() {
+            state = state * 1664525u + 1013904223u;
+            return static_cast<uint8_t>(state >> 24);
+        };
+        for (uint8_t& b : y) b = next();
+        for (uint8_t& b : u) b = next();
+        for (uint8_t& b : v) b = next();
+    }
+
+    void fillConstant(uint8_t yValue, uint8_t uValue, uint8_t vValue)
+    {
+        for (int row = 0; row < height; ++row)
+            for (int x = 0; x < width; ++x)
+                lumaAt(x, row) = yValue;
+        for (int crow = 0; crow < (height + 1) / 2; ++crow)
+        {
+            for (int cx = 0; cx < (width + 1) / 2; ++cx)
+            {
+                uAt(cx, crow) = uValue;
+                vAt(cx, crow) = vValue;
+            }
+        }
+    }
+};
+
+// 转换整帧，返回带哨兵的输出缓冲
+static std::vector<uint8_t> convertPlanes(const YuvConverter& converter, const TestPlanes& planes, bool rgb565, int& dstStride)
+{
+    int bytesPerPixel = rgb565 ? 2 : 4;
+    dstStride = planes.width * bytesPerPixel + GUARD_BYTES;
+    std::vector<uint8_t> dst(static_cast<size_t>(dstStride) * planes.height, GUARD_VALUE);
+    converter.convertRows(planes.y.data(), planes.strideY,
+                          planes.u.data(), planes.strideC,
+                          planes.nv12 ? nullptr : planes.v.data(), planes.nv12 ? 0 : planes.strideC, planes.nv12,
+                          dst.data(), dstStride, rgb565, planes.width, 0, planes.height);
+    return dst;
+}
+
+// BT.601 有限范围的浮点参考，四舍五入后截到 [0, 255]
+static void referencePixel(int y, int u, int v, int rgb[3])
+{
+    double yy = 255.0 / 219.0 * (y - 16);
+    double uu = u - 128;
+    double vv = v - 128;
+    double values[3] = {
+        yy + 1.402 * 255.0 / 224.0 * vv,
+        yy - 0.344136 * 255.0 / 224.0 * uu - 0.714136 * 255.0 / 224.0 * vv,
+        yy + 1.772 * 255.0 / 224.0 * uu
+    };
+    for (int i = 0; i < 3; ++i)
+    {
+        rgb[i] = qBound(0, static_cast<int>(std::lround(values[i])), 255);
+    }
+}
+
+static const int TEST_SIZES[][2] = {
+    { 1, 1 }, { 2, 2 }, { 3, 5 }, { 15, 7 }, { 16, 3 }, { 17, 9 }, { 31, 2 },
+    { 33, 17 }, { 47, 11 }, { 63, 4 }, { 65, 33 }, { 97, 13 }, { 127, 31 }, { 1921, 3 }
+};
+
+class tst_YuvConverter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void kernelsMatchScalar_data();
+    void kernelsMatchScalar();
+    void matchesFloatReference_data();
+    void matchesFloatReference();
+    void rangeExtremes_data();
+    void rangeExtremes();
+};
+
+static void addKernelRows()
+{
+    QTest::addColumn<int>("kernel");
+    QTest::addColumn<bool>("nv12");
+    const YuvConverter::Kernel kernels[] = {
+        YuvConverter::KernelScalar, YuvConverter::KernelSSE41, YuvConverter::KernelAVX2, YuvConverter::KernelNEON
+    };
+    for (YuvConverter::Kernel kernel : kernels)
+    {
+        QTest::newRow(QByteArray(YuvConverter::kernelName(kernel)).append("/i420").constData()) << int(kernel) << false;
+        QTest::newRow(QByteArray(YuvConverter::kernelName(kernel)).append("/nv12").constData()) << int(kernel) << true;
+    }
+}
+
+void tst_YuvConverter::kernelsMatchScalar_data()
+{
+    addKernelRows();
+}
+
+// SIMD 内核与标量实现逐位一致（BGRA 和 RGB565），且不写出行宽之外
+void tst_YuvConverter::kernelsMatchScalar()
+{
+    QFETCH(int, kernel);
+    QFETCH(bool, nv12);
+    if (!YuvConverter::isKernelSupported(YuvConverter::Kernel(kernel)))
+    {
+        QSKIP("kernel not supported on this CPU");
+    }
+
+    YuvConverter scalar(YuvConverter::KernelScalar);
+    YuvConverter simd{YuvConverter::Kernel(kernel)};
+    for (const auto& size : TEST_SIZES)
+    {
+        TestPlanes planes(size[0], size[1], nv12);
+        planes.fillRandom(static_cast<quint32>(size[0] * 131 + size[1]));
+        for (bool rgb565 : { false, true })
+        {
+            int stride = 0;
+            std::vector<uint8_t> expected = convertPlanes(scalar, planes, rgb565, stride);
+            std::vector<uint8_t> actual = convertPlanes(simd, planes, rgb565, stride);
+            int rowBytes = size[0] * (rgb565 ? 2 : 4);
+            for (int row = 0; row < size[1]; ++row)
+            {
+                const uint8_t* e = expected.data() + static_cast<size_t>(row) * stride;
+                const uint8_t* a = actual.data() + static_cast<size_t>(row) * stride;
+                for (int i = 0; i < stride; ++i)
+                {
+                    if (i >= rowBytes)
+                    {
+                        QVERIFY2(a[i] == GUARD_VALUE,
+                                 qPrintable(QString("%1x%2 rgb565=%3 row %4: wrote past the row at byte %5")
+                                                .arg(size[0]).arg(size[1]).arg(rgb565).arg(row).arg(i)));
+                        continue;
+                    }
+                    QVERIFY2(a[i] == e[i],
+                             qPrintable(QString("%1x%2 rgb565=%3 row %4 byte %5: %6 != scalar %7")
+                                            .arg(size[0]).arg(size[1]).arg(rgb565).arg(row).arg(i)
+                                            .arg(a[i]).arg(e[i])));
+                }
+            }
+        }
+    }
+}
+
+void tst_YuvConverter::matchesFloatReference_data()
+{
+    addKernelRows();
+}
+
+// 随机输入与浮点参考相差不超过 1
+void tst_YuvConverter::matchesFloatReference()
+{
+    QFETCH(int, kernel);
+    QFETCH(bool, nv12);
+    if (!YuvConverter::isKernelSupported(YuvConverter::Kernel(kernel)))
+    {
+        QSKIP("kernel not supported on this CPU");
+    }
+
+    YuvConverter converter{YuvConverter::Kernel(kernel)};
+    for (const auto& size : TEST_SIZES)
+    {
+        TestPlanes planes(size[0], size[1], nv12);
+        planes.fillRandom(static_cast<quint32>(size[0] * 7 + size[1] * 1009));
+        int stride = 0;
+        std::vector<uint8_t> out = convertPlanes(converter, planes, false, stride);
+        for (int row = 0; row < size[1]; ++row)
+        {
+            for (int x = 0; x < size[0]; ++x)
+            {
+                int rgb[3];
+                referencePixel(planes.lumaAt(x, row), planes.uAt(x / 2, row / 2), planes.vAt(x / 2, row / 2), rgb);
+                const uint8_t* bgra = out.data() + static_cast<size_t>(row) * stride + x * 4;
+                int actual[3] = { bgra[2], bgra[1], bgra[0] };
+                for (int c = 0; c < 3; ++c)
+                {
+                    QVERIFY2(qAbs(actual[c] - rgb[c]) <= 1,
+                             qPrintable(QString("%1x%2 (%3,%4) channel %5: %6, reference %7")
+                                            .arg(size[0]).arg(size[1]).arg(x).arg(row).arg(c)
+                                            .arg(actual[c]).arg(rgb[c])));
+                }
+                QCOMPARE(int(bgra[3]), 255);
+            }
+        }
+    }
+}
+
+void tst_YuvConverter::rangeExtremes_data()
+{
+    addKernelRows();
+}
+
+// 有限范围的端点: 黑白必须精确，Y=16/235 与 U/V=16/128/240 的各种组合与浮点参考相差不超过 1
+void tst_YuvConverter::rangeExtremes()
+{
+    QFETCH(int, kernel);
+    QFETCH(bool, nv12);
+    if (!YuvConverter::isKernelSupported(YuvConverter::Kernel(kernel)))
+    {
+        QSKIP("kernel not supported on this CPU");
+    }
+
+    YuvConverter converter{YuvConverter::Kernel(kernel)};
+    const int lumaValues[] = { 0, 16, 17, 128, 234, 235, 255 };
+    const int chromaValues[] = { 0, 16, 128, 240, 255 };
+    for (int yValue : lumaValues)
+    {
+        for (int uValue : chromaValues)
+        {
+            for (int vValue : chromaValues)
+            {
+                // 33 像素宽: 两个 SIMD 块加一个标量尾部
+                TestPlanes planes(33, 3, nv12);
+                planes.fillConstant(uint8_t(yValue), uint8_t(uValue), uint8_t(vValue));
+                int stride = 0;
+                std::vector<uint8_t> out = convertPlanes(converter, planes, false, stride);
+                int rgb[3];
+                referencePixel(yValue, uValue, vValue, rgb);
+                for (int row = 0; row < planes.height; ++row)
+                {
+                    for (int x = 0; x < planes.width; ++x)
+                    {
+                        const uint8_t* bgra = out.data() + static_cast<size_t>(row) * stride + x * 4;
+                        int actual[3] = { bgra[2], bgra[1], bgra[0] };
+                        for (int c = 0; c < 3; ++c)
+                        {
+                            QVERIFY2(qAbs(actual[c] - rgb[c]) <= 1,
+                                     qPrintable(QString("Y=%1 U=%2 V=%3 x=%4 channel %5: %6, reference %7")
+                                                    .arg(yValue).arg(uValue).arg(vValue).arg(x).arg(c)
+                                                    .arg(actual[c]).arg(rgb[c])));
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    // 桌面上最常见的纯白和纯黑不允许有偏差
+    for (int yValue : { 235, 16 })
+    {
+        TestPlanes planes(33, 3, nv12);
+        planes.fillConstant(uint8_t(yValue), 128, 128);
+        int stride = 0;
+        std::vector<uint8_t> out = convertPlanes(converter, planes, false, stride);
+        int expected = yValue == 235 ? 255 : 0;
+        for (int x = 0; x < planes.width; ++x)
+        {
+            const uint8_t* bgra = out.data() + x * 4;
+            QCOMPARE(int(bgra[0]), expected);
+            QCOMPARE(int(bgra[1]), expected);
+            QCOMPARE(int(bgra[2]), expected);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(tst_YuvConverter)
+
+#include "tst_yuvconverter.moc"
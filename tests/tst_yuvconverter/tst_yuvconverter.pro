@@ -0,0 +1,15 @@
+QT += testlib
+QT -= gui
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_yuvconverter
+
+INCLUDEPATH += $$PWD/../../src
+
+SOURCES += \
+    tst_yuvconverter.cpp \
+    $$PWD/../../src/YuvConverter.cpp
+
+include($$PWD/../../3rdpart/ffmpeg/ffmpeg.pri)